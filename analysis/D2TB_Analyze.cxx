@@ -0,0 +1,72 @@
+#include "EventReduction.hh"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+void PrintUsage() {
+    std::cout << "Usage: d2tb_analyze [options] file.root [file.root ...]" << std::endl;
+    std::cout << "    -o <file>  -- Write the histograms in this file" << std::endl;
+    std::cout << "    -t <n>     -- Number of threads (0 = all cores)" << std::endl;
+    std::cout << "    -h         -- This help message." << std::endl;
+
+    exit(1);
+}
+
+int main(int argc, char** argv)
+{
+    std::string outputFilename;
+    unsigned int nThreads = 0;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg(argv[i]);
+        if      (arg == "-o" && i+1 < argc) { outputFilename = argv[i+1]; i++; }
+        else if (arg == "-t" && i+1 < argc) { nThreads = std::atoi(argv[i+1]); i++; }
+        else if (arg == "-h" || arg[0] == '-') PrintUsage();
+        else inputs.push_back(arg);
+    }
+
+    if (inputs.empty()) PrintUsage();
+
+    EventReduction reduction(inputs, nThreads);
+    reduction.Process();
+
+    EventReduction::Resolution resolution = reduction.FitResolution();
+
+    std::cout << "\n ======================== Reduction Summary ======================\n";
+    std::cout << "Number of events:\t " << reduction.GetEntries() << std::endl;
+    std::cout << "Detected photons per event:\t " << resolution.Mean
+    << " +- " << resolution.MeanError << std::endl;
+    std::cout << "Fitted sigma:\t " << resolution.Sigma
+    << " +- " << resolution.SigmaError << std::endl;
+    std::cout << "Resolution (sigma/mean):\t " << resolution.GetRelative() << std::endl;
+
+    const TH1D& perCrystal = reduction.GetPhotonsPerCrystal();
+    for (int bin = 1; bin <= perCrystal.GetNbinsX(); bin++) {
+        if (perCrystal.GetBinContent(bin) <= 0) continue;
+        std::cout << "Crystal " << perCrystal.GetBinCenter(bin) << " photons per event:\t "
+        << perCrystal.GetBinContent(bin) << std::endl;
+    }
+
+    const TH1D& arrivalTime = reduction.GetArrivalTime();
+    double timeMax = arrivalTime.GetXaxis()->GetXmax();
+    const double percentiles[] = { 0.05, 0.10, 0.50, 0.90, 0.95 };
+    for (double q : percentiles) {
+        double percentile = reduction.GetTimePercentile(q);
+        std::cout << "Arrival time " << q*100 << "% percentile (ns):\t ";
+        if (std::isinf(percentile)) std::cout << "> " << timeMax << std::endl;
+        else std::cout << percentile << std::endl;
+    }
+    if (reduction.GetLateFraction() > 0) {
+        std::cout << "Photons arrived after " << timeMax << " ns (overflow):\t "
+        << reduction.GetLateFraction()*100 << "%" << std::endl;
+    }
+    std::cout << std::endl;
+
+    if (!outputFilename.empty()) reduction.Write(outputFilename);
+
+    return 0;
+}
@@ -0,0 +1,188 @@
+#include "EventReduction.hh"
+
+#include "TG4Event.hh"
+
+#include <ROOT/TTreeProcessorMT.hxx>
+#include <ROOT/TThreadedObject.hxx>
+#include <TTreeReader.h>
+#include <TTreeReaderValue.h>
+#include <TROOT.h>
+#include <TFile.h>
+#include <TF1.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <string_view>
+
+namespace {
+    // Binning of the (crystal, SiPM) numbers
+    const int kMaxCrystal = 10;
+    const int kMaxSiPM = 100;
+
+    // Binning of the arrival time (0.01 ns bins) used for the percentiles
+    const int kTimeBins = 200000;
+    const double kTimeMax = 2000.;
+
+    // Maximum number of bins of the photons per event distribution
+    const long kMaxEventBins = 1000;
+}
+
+EventReduction::EventReduction(const std::vector<std::string>& files, unsigned int nThreads)
+: fFiles(files),
+fThreads(nThreads),
+fEntries(0)
+{}
+
+EventReduction::~EventReduction() {}
+
+void EventReduction::Process()
+{
+    ROOT::EnableImplicitMT(fThreads);
+    TH1::AddDirectory(false);
+
+    ROOT::TThreadedObject<TH2D> photonsPerSiPM("hPhotonsPerSiPM",
+    "Detected photons per event and SiPM;Crystal;SiPM",
+    kMaxCrystal, -0.5, kMaxCrystal-0.5, kMaxSiPM, -0.5, kMaxSiPM-0.5);
+    ROOT::TThreadedObject<TH1D> photonsPerCrystal("hPhotonsPerCrystal",
+    "Detected photons per event and crystal;Crystal;Photons",
+    kMaxCrystal, -0.5, kMaxCrystal-0.5);
+    ROOT::TThreadedObject<TH1D> arrivalTime("hArrivalTime",
+    "Arrival time of the detected photons;Time (ns);Photons",
+    kTimeBins, 0., kTimeMax);
+
+    // The totals per event are only known once the loop is over, they are
+    // collected once per task and binned at the end.
+    std::mutex totalsMutex;
+    std::vector<long> totals;
+
+    std::vector<std::string_view> filenames(fFiles.begin(), fFiles.end());
+    ROOT::TTreeProcessorMT processor(filenames, "SimEvents");
+
+    processor.Process([&](TTreeReader& reader) {
+        TTreeReaderValue<TG4Event> event(reader, "Event");
+
+        auto hSiPM = photonsPerSiPM.Get();
+        auto hCrystal = photonsPerCrystal.Get();
+        auto hTime = arrivalTime.Get();
+
+        std::vector<long> taskTotals;
+        while (reader.Next()) {
+            long nPhotons = 0;
+            for (const auto& detector : event->Detectors) {
+                for (const auto& hit : detector.second) {
+                    hSiPM->Fill(hit.GetCrystalNumber(), hit.GetSiPMNumber());
+                    hCrystal->Fill(hit.GetCrystalNumber());
+                    hTime->Fill(hit.GetArrivalTime());
+                    ++nPhotons;
+                }
+            }
+            taskTotals.push_back(nPhotons);
+        }
+
+        std::lock_guard<std::mutex> lock(totalsMutex);
+        totals.insert(totals.end(), taskTotals.begin(), taskTotals.end());
+    });
+
+    fPhotonsPerSiPM = photonsPerSiPM.Merge();
+    fPhotonsPerCrystal = photonsPerCrystal.Merge();
+    fArrivalTime = arrivalTime.Merge();
+
+    fEntries = totals.size();
+    if (fEntries > 0) {
+        fPhotonsPerSiPM->Scale(1./fEntries);
+        fPhotonsPerCrystal->Scale(1./fEntries);
+    }
+
+    long minTotal = 0;
+    long maxTotal = 0;
+    if (!totals.empty()) {
+        minTotal = *std::min_element(totals.begin(), totals.end());
+        maxTotal = *std::max_element(totals.begin(), totals.end());
+    }
+    long nBins = std::min(kMaxEventBins, maxTotal - minTotal + 1);
+
+    fPhotonsPerEvent = std::make_shared<TH1D>("hPhotonsPerEvent",
+    "Detected photons per event;Photons;Events",
+    static_cast<int>(nBins), minTotal - 0.5, maxTotal + 0.5);
+    for (long total : totals) fPhotonsPerEvent->Fill(total);
+}
+
+EventReduction::Resolution EventReduction::FitResolution()
+{
+    Resolution result = {0., 0., 0., 0.};
+    if (!fPhotonsPerEvent || fPhotonsPerEvent->GetEntries() < 1) return result;
+
+    double mean = fPhotonsPerEvent->GetMean();
+    double sigma = fPhotonsPerEvent->GetStdDev();
+
+    result.Mean = mean;
+    result.MeanError = fPhotonsPerEvent->GetMeanError();
+    result.Sigma = sigma;
+    result.SigmaError = fPhotonsPerEvent->GetStdDevError();
+    if (sigma <= 0. || fPhotonsPerEvent->GetEntries() < 10) return result;
+
+    // Fit the core of the distribution, the range is refined once around the
+    // fitted peak so that the leakage tail does not bias sigma.
+    TF1 gaussian("fResolution", "gaus", mean - 2*sigma, mean + 2*sigma);
+    gaussian.SetParameters(fPhotonsPerEvent->GetMaximum(), mean, sigma);
+    for (int i = 0; i < 2; ++i) {
+        if (fPhotonsPerEvent->Fit(&gaussian, "QNR") != 0) return result;
+        mean = gaussian.GetParameter(1);
+        sigma = std::abs(gaussian.GetParameter(2));
+        gaussian.SetRange(mean - 2*sigma, mean + 2*sigma);
+    }
+
+    result.Mean = mean;
+    result.MeanError = gaussian.GetParError(1);
+    result.Sigma = sigma;
+    result.SigmaError = gaussian.GetParError(2);
+
+    return result;
+}
+
+double EventReduction::GetTimePercentile(double q) const
+{
+    if (!fArrivalTime || fArrivalTime->GetEntries() < 1) return 0.;
+
+    // The photons arrived after the end of the histogram are counted in the
+    // total, so that the late light does not bias the upper percentiles low
+    int nBins = fArrivalTime->GetNbinsX();
+    double total = fArrivalTime->Integral(0, nBins+1);
+    if (total <= 0.) return 0.;
+
+    double target = q*total;
+    double sum = fArrivalTime->GetBinContent(0);
+    if (sum >= target) return fArrivalTime->GetXaxis()->GetXmin();
+    for (int bin = 1; bin <= nBins; ++bin) {
+        double content = fArrivalTime->GetBinContent(bin);
+        if (content > 0. && sum + content >= target) {
+            return fArrivalTime->GetBinLowEdge(bin)
+            + fArrivalTime->GetBinWidth(bin)*(target - sum)/content;
+        }
+        sum += content;
+    }
+
+    return std::numeric_limits<double>::infinity();
+}
+
+double EventReduction::GetLateFraction() const
+{
+    if (!fArrivalTime) return 0.;
+
+    int nBins = fArrivalTime->GetNbinsX();
+    double total = fArrivalTime->Integral(0, nBins+1);
+    if (total <= 0.) return 0.;
+    return fArrivalTime->GetBinContent(nBins+1)/total;
+}
+
+void EventReduction::Write(const std::string& filename) const
+{
+    TFile output(filename.c_str(), "RECREATE");
+    if (fPhotonsPerSiPM) fPhotonsPerSiPM->Write();
+    if (fPhotonsPerCrystal) fPhotonsPerCrystal->Write();
+    if (fPhotonsPerEvent) fPhotonsPerEvent->Write();
+    if (fArrivalTime) fArrivalTime->Write();
+    output.Close();
+}
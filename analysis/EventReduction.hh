@@ -0,0 +1,81 @@
+#ifndef EventReduction_hh
+#define EventReduction_hh 1
+
+#include <TH1D.h>
+#include <TH2D.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Parallel reduction of the SimEvents tree written by D2TB_Calo.
+///
+/// The event loop runs with TTreeProcessorMT, each task fills its own copy
+/// of the histograms (TThreadedObject) which are merged at the end.  The
+/// ready-made reductions are:
+///   - the number of detected photons per SiPM and per crystal,
+///   - the distribution of the number of detected photons per event and its
+///     gaussian fit (energy resolution),
+///   - the distribution and the percentiles of the photon arrival times.
+class EventReduction {
+public:
+    /// Result of the fit of the number of detected photons per event.
+    struct Resolution {
+        double Mean;
+        double MeanError;
+        double Sigma;
+        double SigmaError;
+
+        /// Relative resolution sigma/mean
+        double GetRelative() const {return Mean > 0 ? Sigma/Mean : 0;}
+    };
+
+    /// Reduce the SimEvents trees of the given files using nThreads threads
+    /// (0 lets ROOT use all the cores).
+    EventReduction(const std::vector<std::string>& files, unsigned int nThreads = 0);
+    virtual ~EventReduction();
+
+    /// Run the event loop.  This must be called before any accessor.
+    void Process();
+
+    /// The number of events read.
+    long GetEntries() const {return fEntries;}
+
+    /// Mean number of detected photons per event for each (crystal, SiPM).
+    const TH2D& GetPhotonsPerSiPM() const {return *fPhotonsPerSiPM;}
+
+    /// Mean number of detected photons per event for each crystal.
+    const TH1D& GetPhotonsPerCrystal() const {return *fPhotonsPerCrystal;}
+
+    /// Distribution of the number of detected photons per event.
+    const TH1D& GetPhotonsPerEvent() const {return *fPhotonsPerEvent;}
+
+    /// Distribution of the photon arrival times (ns).
+    const TH1D& GetArrivalTime() const {return *fArrivalTime;}
+
+    /// Fit a gaussian to the number of detected photons per event.
+    Resolution FitResolution();
+
+    /// Return the arrival time (ns) below which a fraction q of the photons
+    /// arrived.  The photons after the end of the arrival time histogram are
+    /// counted, the percentile is infinite if it falls among them.
+    double GetTimePercentile(double q) const;
+
+    /// The fraction of the photons arrived after the end of the arrival time
+    /// histogram.
+    double GetLateFraction() const;
+
+    /// Write all the histograms in a file.
+    void Write(const std::string& filename) const;
+
+private:
+    std::vector<std::string> fFiles;
+    unsigned int fThreads;
+    long fEntries;
+
+    std::shared_ptr<TH2D> fPhotonsPerSiPM;
+    std::shared_ptr<TH1D> fPhotonsPerCrystal;
+    std::shared_ptr<TH1D> fPhotonsPerEvent;
+    std::shared_ptr<TH1D> fArrivalTime;
+};
+#endif
@@ -1,6 +1,9 @@
 #ifdef __CINT__
 
 #include "TG4Event.hh"
+#include "TG4HitView.hh"
+#include "TG4RunSummary.hh"
+#include "TG4OutputMerger.hh"
 
 #pragma link off all globals;
 #pragma link off all classes;
@@ -11,6 +14,17 @@
 #pragma link C++ class std::vector<TG4PhotonDetHit>+;
 #pragma link C++ class std::map<std::string,std::vector<TG4PhotonDetHit> >+;
 
+#pragma link C++ class TG4Trajectory+;
+#pragma link C++ class std::vector<TG4Trajectory>+;
+
+#pragma link C++ class TG4Genstep+;
+#pragma link C++ class std::vector<TG4Genstep>+;
+
 #pragma link C++ class TG4Event+;
+#pragma link C++ class TG4RunSummary+;
+
+#pragma link C++ class TG4HitView;
+#pragma link C++ class TG4HitChunk;
+#pragma link C++ class TG4OutputMerger;
 
 #endif
@@ -2,6 +2,8 @@
 #define TG4Event_hh 1
 
 #include "TG4PhotonDetHit.hh"
+#include "TG4Trajectory.hh"
+#include "TG4Genstep.hh"
 
 #include <TObject.h>
 
@@ -23,6 +25,14 @@ public:
     /// map is keyed using the sensitive volume name.
     TG4HitDetectors Detectors;
 
-    ClassDef(TG4Event,1)
+    /// The trajectories saved with the event (only filled when they are
+    /// requested), with their points decimated.
+    TG4TrajectoryContainer Trajectories;
+
+    /// The scintillating steps of the event when the optical photons were
+    /// not tracked (/d2tb/genstep/mode record), to be replayed later.
+    TG4GenstepContainer Gensteps;
+
+    ClassDef(TG4Event,3)
 };
 #endif
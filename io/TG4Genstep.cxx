@@ -0,0 +1,4 @@
+#include "TG4Genstep.hh"
+
+ClassImp(TG4Genstep)
+TG4Genstep::~TG4Genstep() {}
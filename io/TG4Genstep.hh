@@ -0,0 +1,61 @@
+#ifndef TG4Genstep_hh
+#define TG4Genstep_hh 1
+
+#include <TLorentzVector.h>
+#include <TObject.h>
+
+#include <vector>
+
+class PersistencyManager;
+class TG4Genstep;
+
+typedef std::vector<TG4Genstep> TG4GenstepContainer;
+
+/// A step which emitted scintillation photons (a "genstep").  The photons
+/// were not tracked, they are emitted again from the step when the event is
+/// replayed (uniformly along the step and over its duration, plus the decay
+/// time of the scintillator).
+class TG4Genstep : public TObject {
+    friend class PersistencyManager;
+public:
+    TG4Genstep()
+    : fTrackId(0), fPDGCode(0), fNumPhotons(0), fEnergyDeposit(0),
+    fStart{0, 0, 0, 0}, fEnd{0, 0, 0, 0} {}
+
+    virtual ~TG4Genstep();
+
+    /// The track which made the step
+    int GetTrackId() const {return fTrackId;}
+
+    /// The PDG code of the particle
+    int GetPDGCode() const {return fPDGCode;}
+
+    /// The number of photons emitted (after the Birks quenching and the
+    /// fluctuations of the yield)
+    int GetNumPhotons() const {return fNumPhotons;}
+
+    /// The energy deposited by the step (in MeV)
+    float GetEnergyDeposit() const {return fEnergyDeposit;}
+
+    /// The position (in mm) and the time (in ns) of the start of the step
+    TLorentzVector GetStart() const {
+        return TLorentzVector(fStart[0], fStart[1], fStart[2], fStart[3]);
+    }
+
+    /// The position (in mm) and the time (in ns) of the end of the step
+    TLorentzVector GetEnd() const {
+        return TLorentzVector(fEnd[0], fEnd[1], fEnd[2], fEnd[3]);
+    }
+
+private:
+
+    Int_t fTrackId;
+    Int_t fPDGCode;
+    Int_t fNumPhotons;
+    Float_t fEnergyDeposit;
+    Float_t fStart[4];
+    Float_t fEnd[4];
+
+    ClassDef(TG4Genstep, 1);
+};
+#endif
@@ -0,0 +1,132 @@
+#include "TG4HitView.hh"
+#include "TG4Event.hh"
+
+#include <TBranch.h>
+
+#include <algorithm>
+#include <string>
+
+namespace {
+    ULong64_t AddressOf(const void* p) {
+        return reinterpret_cast<ULong64_t>(p);
+    }
+
+    Long64_t OffsetOf(const TG4PhotonDetHit& hit, const void* field) {
+        return static_cast<const char*>(field) - reinterpret_cast<const char*>(&hit);
+    }
+
+    void AppendPosition(std::vector<Double_t>& buffer, const TVector3& pos) {
+        buffer.push_back(pos.X());
+        buffer.push_back(pos.Y());
+        buffer.push_back(pos.Z());
+    }
+}
+
+ULong64_t TG4HitView::GetAddress(const TG4PhotonDetHitContainer& hits)
+{
+    if (hits.empty()) return 0;
+    return AddressOf(hits.data());
+}
+
+Long64_t TG4HitView::GetStride()
+{
+    return sizeof(TG4PhotonDetHit);
+}
+
+Long64_t TG4HitView::GetArrivalTimeOffset()
+{
+    TG4PhotonDetHit hit;
+    return OffsetOf(hit, &hit.fArrivalTime);
+}
+
+Long64_t TG4HitView::GetCrystalNumberOffset()
+{
+    TG4PhotonDetHit hit;
+    return OffsetOf(hit, &hit.fCrystalNo);
+}
+
+Long64_t TG4HitView::GetSiPMNumberOffset()
+{
+    TG4PhotonDetHit hit;
+    return OffsetOf(hit, &hit.fSiPMNo);
+}
+
+Long64_t TG4HitView::GetExitPositionOffset()
+{
+    TG4PhotonDetHit hit;
+    return OffsetOf(hit, &hit.fPosExit(0));
+}
+
+Long64_t TG4HitView::GetArrivePositionOffset()
+{
+    TG4PhotonDetHit hit;
+    return OffsetOf(hit, &hit.fPosArrive(0));
+}
+
+Long64_t TG4HitView::GetArriveLocalPositionOffset()
+{
+    TG4PhotonDetHit hit;
+    return OffsetOf(hit, &hit.fPosArriveLocal(0));
+}
+
+TG4HitChunk::TG4HitChunk()
+: fEventOffsets(1, 0)
+{}
+
+TG4HitChunk::~TG4HitChunk() {}
+
+Long64_t TG4HitChunk::Fill(TTree* tree, Long64_t first, Long64_t n, const char* detector)
+{
+    // clear() keeps the capacity, so the buffers stop growing after the first
+    // chunks.
+    fEventOffsets.assign(1, 0);
+    fEventId.clear();
+    fArrivalTime.clear();
+    fCrystalNo.clear();
+    fSiPMNo.clear();
+    fPosExit.clear();
+    fPosArrive.clear();
+    fPosArriveLocal.clear();
+
+    if (!tree) return 0;
+
+    TBranch* branch = tree->GetBranch("Event");
+    if (!branch) return 0;
+
+    TG4Event* event = nullptr;
+    tree->SetBranchAddress("Event", &event);
+
+    std::string selected(detector ? detector : "");
+    Long64_t last = std::min(first + n, tree->GetEntries());
+    for (Long64_t entry = first; entry < last; ++entry) {
+        if (tree->GetEntry(entry) <= 0) break;
+
+        for (const auto& hits : event->Detectors) {
+            if (!selected.empty() && hits.first != selected) continue;
+            for (const auto& hit : hits.second) {
+                fEventId.push_back(event->EventId);
+                fArrivalTime.push_back(hit.GetArrivalTime());
+                fCrystalNo.push_back(hit.GetCrystalNumber());
+                fSiPMNo.push_back(hit.GetSiPMNumber());
+                AppendPosition(fPosExit, hit.GetExitPosition());
+                AppendPosition(fPosArrive, hit.GetArrivePosition());
+                AppendPosition(fPosArriveLocal, hit.GetArriveLocalPosition());
+            }
+        }
+        fEventOffsets.push_back(fArrivalTime.size());
+    }
+
+    tree->ResetBranchAddresses();
+    delete event;
+
+    return GetEvents();
+}
+
+ULong64_t TG4HitChunk::GetEventOffsetsAddress() const {return AddressOf(fEventOffsets.data());}
+ULong64_t TG4HitChunk::GetEventIdAddress() const {return AddressOf(fEventId.data());}
+ULong64_t TG4HitChunk::GetArrivalTimeAddress() const {return AddressOf(fArrivalTime.data());}
+ULong64_t TG4HitChunk::GetCrystalNumberAddress() const {return AddressOf(fCrystalNo.data());}
+ULong64_t TG4HitChunk::GetSiPMNumberAddress() const {return AddressOf(fSiPMNo.data());}
+ULong64_t TG4HitChunk::GetExitPositionAddress() const {return AddressOf(fPosExit.data());}
+ULong64_t TG4HitChunk::GetArrivePositionAddress() const {return AddressOf(fPosArrive.data());}
+ULong64_t TG4HitChunk::GetArriveLocalPositionAddress() const {return AddressOf(fPosArriveLocal.data());}
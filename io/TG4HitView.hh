@@ -0,0 +1,77 @@
+#ifndef TG4HitView_hh
+#define TG4HitView_hh 1
+
+#include "TG4PhotonDetHit.hh"
+
+#include <TTree.h>
+
+#include <vector>
+
+/// Memory layout of the photon detector hits, used to build views (NumPy
+/// arrays, ...) directly over the hit vectors without copying them.
+///
+/// The hits of one detector are stored contiguously in a
+/// TG4PhotonDetHitContainer, so each field is a strided array starting at
+/// GetAddress(hits) + Get...Offset() with a stride of GetStride() bytes.  The
+/// positions are three consecutive doubles (x, y, z).  The views are valid as
+/// long as the container is not modified (i.e. until the next GetEntry).
+class TG4HitView {
+public:
+    /// The address of the first hit of the container (0 if empty).
+    static ULong64_t GetAddress(const TG4PhotonDetHitContainer& hits);
+
+    /// The distance in bytes between two consecutive hits.
+    static Long64_t GetStride();
+
+    /// The offset in bytes of each field inside a hit.
+    static Long64_t GetArrivalTimeOffset();
+    static Long64_t GetCrystalNumberOffset();
+    static Long64_t GetSiPMNumberOffset();
+    static Long64_t GetExitPositionOffset();
+    static Long64_t GetArrivePositionOffset();
+    static Long64_t GetArriveLocalPositionOffset();
+};
+
+/// The hits of a range of events gathered in contiguous arrays, one per field.
+///
+/// Views over the hits of several events cannot be built without gathering
+/// them, this is done once here in compiled code instead of creating a Python
+/// object for every hit and every TVector3.  The buffers are reused by the
+/// next call to Fill, so their addresses are only valid until then.
+class TG4HitChunk {
+public:
+    TG4HitChunk();
+    virtual ~TG4HitChunk();
+
+    /// Read the events [first, first+n) of the SimEvents tree (or chain) and
+    /// gather their hits.  Only the hits of the given sensitive detector are
+    /// kept if detector is not empty.  Return the number of events read.
+    Long64_t Fill(TTree* tree, Long64_t first, Long64_t n, const char* detector = "");
+
+    /// The number of events and hits in the chunk.
+    Long64_t GetEvents() const {return fEventOffsets.size() - 1;}
+    Long64_t GetHits() const {return fArrivalTime.size();}
+
+    /// The addresses of the buffers.  EventOffsets has GetEvents()+1 entries
+    /// (the hits of event i are [EventOffsets[i], EventOffsets[i+1])), the
+    /// positions have 3*GetHits() entries and the others GetHits() entries.
+    ULong64_t GetEventOffsetsAddress() const;
+    ULong64_t GetEventIdAddress() const;
+    ULong64_t GetArrivalTimeAddress() const;
+    ULong64_t GetCrystalNumberAddress() const;
+    ULong64_t GetSiPMNumberAddress() const;
+    ULong64_t GetExitPositionAddress() const;
+    ULong64_t GetArrivePositionAddress() const;
+    ULong64_t GetArriveLocalPositionAddress() const;
+
+private:
+    std::vector<Long64_t> fEventOffsets;
+    std::vector<Int_t> fEventId;
+    std::vector<Float_t> fArrivalTime;
+    std::vector<Int_t> fCrystalNo;
+    std::vector<Int_t> fSiPMNo;
+    std::vector<Double_t> fPosExit;
+    std::vector<Double_t> fPosArrive;
+    std::vector<Double_t> fPosArriveLocal;
+};
+#endif
@@ -0,0 +1,155 @@
+#include "TG4OutputMerger.hh"
+#include "TG4Event.hh"
+
+#include <TFile.h>
+#include <TFileMerger.h>
+#include <TNamed.h>
+#include <TTree.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+
+namespace {
+    // The metadata written by the persistency manager, rewritten after the
+    // merge.
+    const char* kMetadata = "RunSummary RunId FileIndex FirstEventId LastEventId BaseFilename";
+}
+
+TG4OutputMerger::TG4OutputMerger() {}
+
+TG4OutputMerger::~TG4OutputMerger() {}
+
+void TG4OutputMerger::AddFile(const std::string& filename)
+{
+    fFiles.push_back(filename);
+}
+
+long TG4OutputMerger::GetFirstEventId(const std::string& filename) const
+{
+    TFile* file = TFile::Open(filename.c_str(), "READ");
+    if (!file || file->IsZombie()) {
+        delete file;
+        return -1;
+    }
+
+    long first = -1;
+    TNamed* named = dynamic_cast<TNamed*>(file->Get("FirstEventId"));
+    if (named) first = std::atol(named->GetTitle());
+
+    // A file left by a stopped job has no metadata
+    TTree* tree = dynamic_cast<TTree*>(file->Get("SimEvents"));
+    if (first < 0 && tree && tree->GetEntries() > 0) {
+        TG4Event* event = nullptr;
+        tree->SetBranchAddress("Event", &event);
+        tree->GetEntry(0);
+        first = event->EventId;
+        tree->ResetBranchAddresses();
+        delete event;
+    }
+
+    file->Close();
+    delete file;
+
+    return first;
+}
+
+void TG4OutputMerger::AddRunSummaries(const std::string& filename)
+{
+    TFile* file = TFile::Open(filename.c_str(), "READ");
+    if (!file || file->IsZombie()) {
+        delete file;
+        return;
+    }
+
+    TTree* tree = dynamic_cast<TTree*>(file->Get("RunSummary"));
+    if (tree) {
+        TG4RunSummary* summary = nullptr;
+        tree->SetBranchAddress("Run", &summary);
+        for (Long64_t i = 0; i < tree->GetEntries(); ++i) {
+            tree->GetEntry(i);
+            auto entry = fSummaries.find(summary->RunId);
+            if (entry == fSummaries.end()) fSummaries[summary->RunId] = *summary;
+            else entry->second.Merge(*summary);
+        }
+        tree->ResetBranchAddresses();
+        delete summary;
+    }
+
+    file->Close();
+    delete file;
+}
+
+bool TG4OutputMerger::Merge(const std::string& output)
+{
+    fSummaries.clear();
+    if (fFiles.empty()) return false;
+
+    // Order the files by their first event (the files without events last)
+    std::vector<std::pair<long, std::string> > ordered;
+    for (const auto& filename : fFiles) {
+        long first = GetFirstEventId(filename);
+        ordered.push_back(std::make_pair(first < 0 ? LONG_MAX : first, filename));
+    }
+    std::stable_sort(ordered.begin(), ordered.end(),
+    [](const std::pair<long, std::string>& a, const std::pair<long, std::string>& b) {
+        return a.first < b.first;
+    });
+
+    TFileMerger merger(false);
+    if (!merger.OutputFile(output.c_str(), "RECREATE")) return false;
+    for (const auto& file : ordered) {
+        if (!merger.AddFile(file.second.c_str())) return false;
+        AddRunSummaries(file.second);
+    }
+
+    merger.AddObjectNames(kMetadata);
+    if (!merger.PartialMerge(TFileMerger::kAll | TFileMerger::kRegular | TFileMerger::kSkipListed)) {
+        return false;
+    }
+
+    // Write the combined summaries and the metadata of the merged file
+    TFile* file = TFile::Open(output.c_str(), "UPDATE");
+    if (!file || file->IsZombie()) {
+        delete file;
+        return false;
+    }
+
+    TTree* tree = new TTree("RunSummary", "Run Summaries");
+    TG4RunSummary summary;
+    TG4RunSummary* pSummary = &summary;
+    tree->Branch("Run", "TG4RunSummary", &pSummary);
+    for (const auto& run : fSummaries) {
+        summary = run.second;
+        tree->Fill();
+    }
+
+    long firstEvent = -1;
+    long lastEvent = -1;
+    TTree* events = dynamic_cast<TTree*>(file->Get("SimEvents"));
+    if (events && events->GetEntries() > 0) {
+        TG4Event* event = nullptr;
+        events->SetBranchAddress("Event", &event);
+        events->GetEntry(0);
+        firstEvent = event->EventId;
+        events->GetEntry(events->GetEntries()-1);
+        lastEvent = event->EventId;
+        events->ResetBranchAddresses();
+        delete event;
+    }
+
+    int runId = fSummaries.empty() ? 0 : fSummaries.begin()->first;
+    TNamed("RunId", std::to_string(runId).c_str()).Write();
+    TNamed("FileIndex", "0").Write();
+    TNamed("FirstEventId", std::to_string(firstEvent).c_str()).Write();
+    TNamed("LastEventId", std::to_string(lastEvent).c_str()).Write();
+    TNamed("BaseFilename", output.c_str()).Write();
+
+    file->Write();
+    file->Close();
+    delete file;
+
+    return true;
+}
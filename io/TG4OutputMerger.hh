@@ -0,0 +1,44 @@
+#ifndef TG4OutputMerger_hh
+#define TG4OutputMerger_hh 1
+
+#include "TG4RunSummary.hh"
+
+#include <map>
+#include <string>
+#include <vector>
+
+/// Merge output files of D2TB_Calo written by separate processes (or the
+/// numbered files of a rotated output).
+///
+/// The input files are ordered by their first event id, and the SimEvents
+/// trees are concatenated in that order, so the merged tree is in event id
+/// order as long as each input is.  The histograms of the Run_<id>
+/// directories are added, the RunSummary entries of the same run are
+/// combined (TG4RunSummary::Merge) and the run metadata are rewritten for
+/// the merged file.
+class TG4OutputMerger {
+public:
+    TG4OutputMerger();
+    virtual ~TG4OutputMerger();
+
+    /// Add an input file.
+    void AddFile(const std::string& filename);
+
+    /// Merge the input files in the output file.  Return false if the merge
+    /// failed.
+    bool Merge(const std::string& output);
+
+    /// The combined summaries of the runs, by run id (after Merge).
+    const std::map<int, TG4RunSummary>& GetRunSummaries() const {return fSummaries;}
+
+private:
+    /// Read the first event id of a file (-1 if it has no event).
+    long GetFirstEventId(const std::string& filename) const;
+
+    /// Read and combine the RunSummary tree of a file.
+    void AddRunSummaries(const std::string& filename);
+
+    std::vector<std::string> fFiles;
+    std::map<int, TG4RunSummary> fSummaries;
+};
+#endif
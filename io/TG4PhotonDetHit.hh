@@ -8,6 +8,7 @@
 #include <vector>
 
 class PersistencyManager;
+class TG4HitView;
 class TG4PhotonDetHit;
 
 typedef std::vector<TG4PhotonDetHit> TG4PhotonDetHitContainer;
@@ -15,6 +16,7 @@ typedef std::map<std::string,TG4PhotonDetHitContainer> TG4HitDetectors;
 
 class TG4PhotonDetHit : public TObject {
     friend class PersistencyManager;
+    friend class TG4HitView;
 public:
     TG4PhotonDetHit()
     : fArrivalTime(0), fCrystalNo(0), fSiPMNo(0),
@@ -0,0 +1,42 @@
+#include "TG4RunSummary.hh"
+
+#include <cmath>
+
+ClassImp(TG4RunSummary)
+
+TG4RunSummary::~TG4RunSummary() {}
+
+double TG4RunSummary::GetDetectedVariance() const
+{
+    if (Events < 2) return 0;
+    return DetectedM2/(Events-1);
+}
+
+double TG4RunSummary::GetDetectedSigma() const
+{
+    return std::sqrt(GetDetectedVariance());
+}
+
+double TG4RunSummary::GetResolution() const
+{
+    if (DetectedMean <= 0) return 0;
+    return GetDetectedSigma()/DetectedMean;
+}
+
+void TG4RunSummary::Merge(const TG4RunSummary& other)
+{
+    if (other.Events == 0) return;
+
+    // Combine the two running means and variances (Chan et al.)
+    double n1 = Events;
+    double n2 = other.Events;
+    double delta = other.DetectedMean - DetectedMean;
+    DetectedMean += delta*n2/(n1+n2);
+    DetectedM2 += other.DetectedM2 + delta*delta*n1*n2/(n1+n2);
+
+    Events += other.Events;
+    DetectedPhotons += other.DetectedPhotons;
+    ScintPhotons += other.ScintPhotons;
+    Absorbed += other.Absorbed;
+    BoundaryAbsorbed += other.BoundaryAbsorbed;
+}
@@ -0,0 +1,50 @@
+#ifndef TG4RunSummary_hh
+#define TG4RunSummary_hh 1
+
+#include <TObject.h>
+
+/// The statistics of one run, accumulated during the simulation.  It is
+/// written once per run in the RunSummary tree.
+class TG4RunSummary : public TObject {
+public:
+    TG4RunSummary(void)
+    : RunId(0), Events(0), DetectedPhotons(0), ScintPhotons(0),
+    Absorbed(0), BoundaryAbsorbed(0), DetectedMean(0), DetectedM2(0) {}
+    virtual ~TG4RunSummary();
+
+    /// The run number
+    int RunId;
+
+    /// The number of events in the run
+    long Events;
+
+    /// The total number of photons detected by the SiPMs
+    long DetectedPhotons;
+
+    /// The total number of scintillation photons
+    long ScintPhotons;
+
+    /// The total number of absorbed photons (bulk and boundary)
+    long Absorbed;
+    long BoundaryAbsorbed;
+
+    /// Running mean and sum of squared deviations (Welford) of the number of
+    /// detected photons per event.
+    double DetectedMean;
+    double DetectedM2;
+
+    /// Variance and standard deviation of the number of detected photons per
+    /// event.
+    double GetDetectedVariance() const;
+    double GetDetectedSigma() const;
+
+    /// The relative resolution sigma/mean of the number of detected photons
+    /// per event.
+    double GetResolution() const;
+
+    /// Add the statistics of another run (or part of a run).
+    void Merge(const TG4RunSummary& other);
+
+    ClassDef(TG4RunSummary,1)
+};
+#endif
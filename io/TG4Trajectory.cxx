@@ -0,0 +1,4 @@
+#include "TG4Trajectory.hh"
+
+ClassImp(TG4Trajectory)
+TG4Trajectory::~TG4Trajectory() {}
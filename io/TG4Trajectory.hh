@@ -0,0 +1,59 @@
+#ifndef TG4Trajectory_hh
+#define TG4Trajectory_hh 1
+
+#include <TVector3.h>
+#include <TObject.h>
+
+#include <vector>
+
+class PersistencyManager;
+class TG4Trajectory;
+
+typedef std::vector<TG4Trajectory> TG4TrajectoryContainer;
+
+class TG4Trajectory : public TObject {
+    friend class PersistencyManager;
+public:
+    TG4Trajectory()
+    : fTrackId(0), fParentId(0), fPDGCode(0),
+    fInitialMomentum{0, 0, 0} {}
+
+    virtual ~TG4Trajectory();
+
+    /// The track number (starting from 1)
+    int GetTrackId() const {return fTrackId;}
+
+    /// The number of the parent track (0 for a primary particle)
+    int GetParentId() const {return fParentId;}
+
+    /// The PDG code of the particle
+    int GetPDGCode() const {return fPDGCode;}
+
+    /// The momentum of the particle at its vertex (in MeV)
+    TVector3 GetInitialMomentum() const {
+        return TVector3(fInitialMomentum[0], fInitialMomentum[1], fInitialMomentum[2]);
+    }
+
+    /// The number of points kept, the first one is the vertex and the last
+    /// one the end of the track
+    std::size_t GetNumberOfPoints() const {return fPoints.size()/3;}
+
+    /// The position of a point (in mm)
+    TVector3 GetPoint(std::size_t i) const {
+        return TVector3(fPoints[3*i], fPoints[3*i+1], fPoints[3*i+2]);
+    }
+
+    /// The coordinates of the points packed as x0 y0 z0 x1 y1 z1 ... (in mm)
+    const std::vector<Float_t>& GetPoints() const {return fPoints;}
+
+private:
+
+    Int_t fTrackId;
+    Int_t fParentId;
+    Int_t fPDGCode;
+    Float_t fInitialMomentum[3];
+    std::vector<Float_t> fPoints;
+
+    ClassDef(TG4Trajectory, 1);
+};
+#endif
@@ -3,19 +3,38 @@
 #include "PhysicsList.hh"
 #include "PersistencyManager.hh"
 #include "PersistencyRootManager.hh"
+#include "LoggerMessenger.hh"
+#include "SeedMessenger.hh"
+#include "TrajectoryMessenger.hh"
+#include "GenstepMessenger.hh"
+#include "CheckpointManager.hh"
+#include "MultiProcessRunner.hh"
+#include "ScanDriver.hh"
+#include "StackingAction.hh"
 
-#ifdef G4MULTITHREADED
-#include "G4MTRunManager.hh"
-#else
+#include "G4Version.hh"
+#include "G4Threading.hh"
 #include "G4RunManager.hh"
+#if G4VERSION_NUMBER >= 1070
+#include "G4RunManagerFactory.hh"
+#elif defined(G4MULTITHREADED)
+#include "G4MTRunManager.hh"
 #endif
 
 #include "G4UImanager.hh"
 #include "G4UIcommand.hh"
 
+// The batch executable is built without the visualization and the UI
+// sessions (D2TB_BATCH)
+#ifndef D2TB_BATCH
 #include "G4VisExecutive.hh"
 #include "G4UIExecutive.hh"
 #include "G4UIterminal.hh"
+#else
+#include "G4UIbatch.hh"
+#endif
+
+#include <cstdlib>
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -23,9 +42,19 @@ void PrintUsage() {
     std::cout << "Usage: d2tb_calo [options]" << std::endl;
     std::cout << "    -m      -- Use the macro specified after" << std::endl;
     std::cout << "    -o      -- Set the output file" << std::endl;
+    #ifndef D2TB_BATCH
     std::cout << "    -U      -- Start an interactive run" << std::endl;
+    #endif
     std::cout << "    -v      -- Validate the geometry" << std::endl;
     std::cout << "    -e <n>  -- Number of events to run" << std::endl;
+    std::cout << "    -c <n>  -- Save a checkpoint every n events" << std::endl;
+    std::cout << "    --resume <file> -- Continue the job saved in a checkpoint file" << std::endl;
+    std::cout << "    -s <n>  -- Master seed of the events" << std::endl;
+    std::cout << "    -f <n>  -- Id of the first event" << std::endl;
+    std::cout << "    -t <n>  -- Number of worker threads (0 = all cores)" << std::endl;
+    std::cout << "    -j <n>  -- Number of processes (the outputs are merged at the end, serial run manager only)" << std::endl;
+    std::cout << "    -r <type> -- Run manager: default, serial, mt, tasking, tbb or subevt" << std::endl;
+    std::cout << "    -p <n>  -- Optical photons per sub-event (with -r subevt)" << std::endl;
     std::cout << "    -h      -- This help message." << std::endl;
 
     exit(1);
@@ -36,22 +65,42 @@ void PrintUsage() {
 int main(int argc, char** argv)
 {
     // Evaluate arguments
-    if ( argc < 2 || argc > 11 ) {
+    if ( argc < 2 ) {
         PrintUsage();
     }
 
     G4String macro;
     G4String outputFilename;
     G4String nEvts;
+    G4String nThreadsArg;
+    G4String seed;
+    G4String firstEvent;
+    G4String checkpointEvts;
+    G4String resumeFilename;
+    G4String runManagerType = "default";
+    G4int nProcesses = 1;
+    G4int subEventSize = 10000;
+    #ifndef D2TB_BATCH
     bool useUI = false;
+    #endif
     bool validateGeo = false;
 
     for ( G4int i = 1; i < argc; i++ ) {
         if      ( G4String(argv[i]) == "-m" ) { macro = argv[i+1]; i++; }
         else if ( G4String(argv[i]) == "-o" ) { outputFilename = argv[i+1]; i++; }
+        #ifndef D2TB_BATCH
         else if ( G4String(argv[i]) == "-U" ) useUI = true;
+        #endif
         else if ( G4String(argv[i]) == "-v" ) validateGeo = true;
         else if ( G4String(argv[i]) == "-e" ) { nEvts = argv[i+1]; i++; }
+        else if ( G4String(argv[i]) == "-s" ) { seed = argv[i+1]; i++; }
+        else if ( G4String(argv[i]) == "-f" ) { firstEvent = argv[i+1]; i++; }
+        else if ( G4String(argv[i]) == "-c" ) { checkpointEvts = argv[i+1]; i++; }
+        else if ( G4String(argv[i]) == "--resume" ) { resumeFilename = argv[i+1]; i++; }
+        else if ( G4String(argv[i]) == "-t" ) { nThreadsArg = argv[i+1]; i++; }
+        else if ( G4String(argv[i]) == "-r" ) { runManagerType = argv[i+1]; i++; }
+        else if ( G4String(argv[i]) == "-j" ) { nProcesses = G4UIcommand::ConvertToInt(argv[i+1]); i++; }
+        else if ( G4String(argv[i]) == "-p" ) { subEventSize = G4UIcommand::ConvertToInt(argv[i+1]); i++; }
         else if ( G4String(argv[i]) == "-h" ) {
             PrintUsage();
         }
@@ -61,18 +110,71 @@ int main(int argc, char** argv)
     }
 
     G4UIsession *session = nullptr;
+    #ifndef D2TB_BATCH
     G4UIExecutive* ui = nullptr;
+    #endif
 
     // Choose the Random engine
     G4Random::setTheEngine(new CLHEP::RanecuEngine);
 
-    // Construct the default run manager
-    #ifdef G4MULTITHREADED
-    G4MTRunManager * runManager = new G4MTRunManager;
+    // The processes are forked from a sequential run manager.  A threaded
+    // run manager has its worker threads already running when the processes
+    // are forked, which can deadlock them.
+    if (nProcesses > 1 && runManagerType == "default") runManagerType = "serial";
+    if (nProcesses > 1 && runManagerType != "serial") {
+        std::cout << "-j " << nProcesses << " needs the serial run manager, not -r "
+        << runManagerType << std::endl;
+        PrintUsage();
+    }
+
+    // Number of worker threads: the -t option, then the D2TB_NTHREADS
+    // environment variable, then at most 4.  Zero means all the cores.
     G4int nThreads = std::min(G4Threading::G4GetNumberOfCores(), 4);
+    if (const char* env = std::getenv("D2TB_NTHREADS")) nThreads = std::atoi(env);
+    if (nThreadsArg.size()) nThreads = G4UIcommand::ConvertToInt(nThreadsArg);
+    if (nThreads <= 0) nThreads = G4Threading::G4GetNumberOfCores();
+
+    // Construct the run manager
+    #if G4VERSION_NUMBER >= 1070
+    G4RunManagerType type = G4RunManagerType::Default;
+    if      (runManagerType == "serial")  type = G4RunManagerType::Serial;
+    else if (runManagerType == "mt")      type = G4RunManagerType::MT;
+    else if (runManagerType == "tasking") type = G4RunManagerType::Tasking;
+    else if (runManagerType == "tbb")     type = G4RunManagerType::TBB;
+    #if G4VERSION_NUMBER >= 1120
+    else if (runManagerType == "subevt")  type = G4RunManagerType::SubEvt;
+    #endif
+    else if (runManagerType != "default") PrintUsage();
+
+    G4RunManager * runManager = G4RunManagerFactory::CreateRunManager(type);
     runManager->SetNumberOfThreads(nThreads);
+
+    #if G4VERSION_NUMBER >= 1120
+    // The scintillation photons of an event are tracked by all the threads,
+    // in bunches of subEventSize photons.
+    if (type == G4RunManagerType::SubEvt && subEventSize > 0) {
+        runManager->RegisterSubEventType(0, subEventSize);
+        StackingAction::SetSubEventSize(subEventSize);
+    }
+    #endif
     G4cout << "===== D2TB_Calo is started with "
     <<  runManager->GetNumberOfThreads() << " threads =====" << G4endl;
+    #elif defined(G4MULTITHREADED)
+    G4RunManager * runManager = nullptr;
+    if (runManagerType == "serial") {
+        runManager = new G4RunManager;
+    }
+    else {
+        if (runManagerType != "default" && runManagerType != "mt") {
+            G4cout << "===== The " << runManagerType << " run manager needs Geant4 10.7,"
+            << " using the MT run manager =====" << G4endl;
+        }
+        G4MTRunManager * mtRunManager = new G4MTRunManager;
+        mtRunManager->SetNumberOfThreads(nThreads);
+        G4cout << "===== D2TB_Calo is started with "
+        <<  mtRunManager->GetNumberOfThreads() << " threads =====" << G4endl;
+        runManager = mtRunManager;
+    }
     #else
     G4RunManager * runManager = new G4RunManager;
     #endif
@@ -98,14 +200,48 @@ int main(int argc, char** argv)
         persistencyManager = new PersistencyManager();
     }
 
+    // Commands to control the messages of the user actions
+    auto loggerMessenger = new LoggerMessenger();
+
+    // Commands to control the seeds of the events
+    auto seedMessenger = new SeedMessenger();
+
+    // Commands to select the tracks which keep a trajectory
+    auto trajectoryMessenger = new TrajectoryMessenger();
+
+    // Commands to record the scintillating steps and replay their photons
+    auto genstepMessenger = new GenstepMessenger();
+
+    // Runs split in blocks with a checkpoint after each one
+    auto checkpointManager = new CheckpointManager(persistencyManager);
+
+    // Scans of the detector parameters in one process
+    auto scanDriver = new ScanDriver(detConstruction);
+
     // Get the pointer to the User Interface manager
     auto UImanager = G4UImanager::GetUIpointer();
 
-    // Open the file if one was declared on the command line.
-    if (persistencyManager && ! outputFilename.empty()) {
+    if (seed.size()) {
+        UImanager->ApplyCommand("/d2tb/run/seed " + seed);
+    }
+
+    if (firstEvent.size()) {
+        UImanager->ApplyCommand("/d2tb/run/firstEvent " + firstEvent);
+    }
+
+    if (checkpointEvts.size()) {
+        UImanager->ApplyCommand("/d2tb/run/checkpoint " + checkpointEvts);
+    }
+
+    // Open the file if one was declared on the command line.  A resumed job
+    // reopens the output of the checkpoint instead, and each process of a
+    // multi-process job writes its own.
+    if (nProcesses > 1 && outputFilename.empty()) outputFilename = "simulation-output.root";
+    if (persistencyManager && ! outputFilename.empty() && resumeFilename.empty() && nProcesses <= 1) {
         UImanager->ApplyCommand("/d2tb/root/open "+outputFilename);
     }
 
+    #ifndef D2TB_BATCH
     G4VisManager* visManager = new G4VisExecutive;
     visManager->Initialize();
 
@@ -120,14 +256,27 @@ int main(int argc, char** argv)
         ui->SessionStart();
         delete ui;
     }
-    else{
+    else
+    #endif
+    {
         if ( macro.size() ) {
             UImanager->ApplyCommand("/control/execute " + macro);
-            if (nEvts.size()) {
-                UImanager->ApplyCommand("/run/beamOn " + nEvts);
+            if (resumeFilename.size()) {
+                UImanager->ApplyCommand("/d2tb/run/resume " + resumeFilename);
+            } else if (nEvts.size() && nProcesses > 1) {
+                MultiProcessRunner runner(persistencyManager, nProcesses);
+                runner.BeamOn(G4UIcommand::ConvertToInt(nEvts), outputFilename);
+            } else if (nEvts.size()) {
+                UImanager->ApplyCommand("/d2tb/run/beamOn " + nEvts);
             } else {
                 //keep G4 idle
+                #ifndef D2TB_BATCH
                 session = new G4UIterminal();
+                #else
+                // The terminal is in the UI libraries, the commands are
+                // read from the standard input
+                session = new G4UIbatch("/dev/stdin");
+                #endif
                 session->SessionStart();
             }
         }
@@ -144,7 +293,16 @@ int main(int argc, char** argv)
 
     if(session) delete session;
 
+    delete loggerMessenger;
+    delete seedMessenger;
+    delete trajectoryMessenger;
+    delete genstepMessenger;
+    delete checkpointManager;
+    delete scanDriver;
+
+    #ifndef D2TB_BATCH
     delete visManager;
+    #endif
     delete runManager;
 
     return 0;
@@ -0,0 +1,146 @@
+"""NumPy access to the photon detector hits written by D2TB_Calo.
+
+The arrays are views over the buffers of the root_io library, nothing is
+converted hit by hit in Python:
+
+  - event_hits() gives views over the hit vector of one event, they are
+    valid until the next GetEntry of the tree;
+  - iterate() gathers the hits of chunks of events in contiguous buffers (in
+    compiled code, TG4HitChunk) and yields views over them, they are valid
+    until the next chunk is read.
+
+Call .copy() on the arrays that must outlive these.
+
+Example:
+
+    import d2tb_io
+    for chunk in d2tb_io.iterate(["output.root"], chunk_size=10000):
+        times = chunk["arrival_time"]          # float32, (n,)
+        positions = chunk["arrive_position"]   # float64, (n, 3)
+"""
+
+import ctypes
+import os
+
+import numpy as np
+import ROOT
+
+__all__ = ["load", "open_tree", "event_hits", "iterate"]
+
+_loaded = False
+
+
+def load(library=None):
+    """Load the root_io library (lib/libroot_io by default)."""
+    global _loaded
+    if _loaded:
+        return
+    if library is None:
+        library = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                               os.pardir, "lib", "libroot_io")
+    if ROOT.gSystem.Load(library) < 0:
+        raise RuntimeError("cannot load " + library)
+    _loaded = True
+
+
+def open_tree(filenames):
+    """Return a TChain of the SimEvents trees of the given files."""
+    load()
+    if isinstance(filenames, str):
+        filenames = [filenames]
+    chain = ROOT.TChain("SimEvents")
+    for filename in filenames:
+        chain.Add(filename)
+    return chain
+
+
+def _view(address, dtype, count, width=1, offset=0, stride=None):
+    """Build an array over count elements of memory starting at address."""
+    dtype = np.dtype(dtype)
+    shape = (count,) if width == 1 else (count, width)
+    if count == 0 or address == 0:
+        return np.empty(shape, dtype)
+    if stride is None:
+        stride = width * dtype.itemsize
+    size = offset + (count - 1) * stride + width * dtype.itemsize
+    buffer = (ctypes.c_char * size).from_address(address)
+    strides = (stride,) if width == 1 else (stride, dtype.itemsize)
+    array = np.ndarray(shape, dtype, buffer=buffer, offset=offset, strides=strides)
+    array.flags.writeable = False
+    return array
+
+
+def event_hits(event, detector=None):
+    """Return the hits of one TG4Event as a dict of arrays.
+
+    The arrays are strided views over the TG4PhotonDetHit vector of the
+    event.  If detector is None the event must contain a single sensitive
+    detector, otherwise its name selects the hits.
+    """
+    load()
+    if detector is None:
+        if event.Detectors.size() != 1:
+            raise ValueError("the event has %d detectors, select one"
+                             % event.Detectors.size())
+        hits = next(iter(event.Detectors)).second
+    else:
+        hits = event.Detectors[detector]
+
+    view = ROOT.TG4HitView
+    address = int(view.GetAddress(hits))
+    count = int(hits.size())
+    stride = int(view.GetStride())
+
+    return {
+        "arrival_time": _view(address, np.float32, count, 1,
+                              int(view.GetArrivalTimeOffset()), stride),
+        "crystal": _view(address, np.int32, count, 1,
+                         int(view.GetCrystalNumberOffset()), stride),
+        "sipm": _view(address, np.int32, count, 1,
+                      int(view.GetSiPMNumberOffset()), stride),
+        "exit_position": _view(address, np.float64, count, 3,
+                               int(view.GetExitPositionOffset()), stride),
+        "arrive_position": _view(address, np.float64, count, 3,
+                                 int(view.GetArrivePositionOffset()), stride),
+        "arrive_local_position": _view(address, np.float64, count, 3,
+                                       int(view.GetArriveLocalPositionOffset()), stride),
+    }
+
+
+def _chunk_arrays(chunk):
+    events = int(chunk.GetEvents())
+    hits = int(chunk.GetHits())
+    return {
+        "event_offsets": _view(int(chunk.GetEventOffsetsAddress()), np.int64, events + 1),
+        "event_id": _view(int(chunk.GetEventIdAddress()), np.int32, hits),
+        "arrival_time": _view(int(chunk.GetArrivalTimeAddress()), np.float32, hits),
+        "crystal": _view(int(chunk.GetCrystalNumberAddress()), np.int32, hits),
+        "sipm": _view(int(chunk.GetSiPMNumberAddress()), np.int32, hits),
+        "exit_position": _view(int(chunk.GetExitPositionAddress()), np.float64, hits, 3),
+        "arrive_position": _view(int(chunk.GetArrivePositionAddress()), np.float64, hits, 3),
+        "arrive_local_position": _view(int(chunk.GetArriveLocalPositionAddress()),
+                                       np.float64, hits, 3),
+    }
+
+
+def iterate(filenames, chunk_size=10000, detector="", start=0, stop=None):
+    """Yield the hits of chunk_size events at a time as a dict of arrays.
+
+    Besides the hit fields, each chunk has "event_id" (one per hit) and
+    "event_offsets": the hits of the i-th event of the chunk are
+    [event_offsets[i], event_offsets[i+1]).  The buffers are reused, so the
+    arrays of a chunk are overwritten when the next one is read.
+    """
+    tree = open_tree(filenames)
+    entries = int(tree.GetEntries())
+    if stop is None or stop > entries:
+        stop = entries
+
+    chunk = ROOT.TG4HitChunk()
+    first = start
+    while first < stop:
+        n = min(chunk_size, stop - first)
+        if chunk.Fill(tree, first, n, detector) <= 0:
+            break
+        yield _chunk_arrays(chunk)
+        first += n
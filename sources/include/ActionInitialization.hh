@@ -21,6 +21,10 @@ public:
     virtual void Build() const;
 
 private:
+    /// The actions of the event loop, for the workers and for the master of
+    /// the sub-event run manager.
+    void BuildEventActions() const;
+
     DetectorConstruction* fDetConstruction;
 };
 
@@ -0,0 +1,71 @@
+#ifndef CheckpointManager_hh
+#define CheckpointManager_hh 1
+
+#include "TG4RunSummary.hh"
+
+#include "globals.hh"
+
+#include <map>
+
+class PersistencyManager;
+class CheckpointMessenger;
+
+/// Run a number of events in blocks and save a checkpoint after each block.
+///
+/// Each block is a Geant4 run of at most the checkpoint interval, the events
+/// keep the ids they would have in a single run (/d2tb/run/firstEvent) and
+/// are seeded from the master seed and their ids, so the random state of the
+/// job is fully described by the master seed, the next event id and the next
+/// run id.  After each block the output is flushed and the checkpoint file
+/// records these, the output file state and the counters of the blocks done
+/// so far.  Resume continues the job from the checkpoint and appends to the
+/// same output.  The blocks only write their Run_<id> histograms, the
+/// counters of the whole job are written as one run summary, with the id of
+/// its first block, once the last block is done.
+class CheckpointManager
+{
+public:
+    CheckpointManager(PersistencyManager* persistencyManager);
+    virtual ~CheckpointManager();
+
+    /// Save a checkpoint every n events (0 disables the checkpoints).
+    void SetInterval(G4int n) { fInterval = n; }
+    G4int GetInterval() const { return fInterval; }
+
+    /// The name of the checkpoint file.
+    void SetFilename(const G4String& filename) { fFilename = filename; }
+    const G4String& GetFilename() const { return fFilename; }
+
+    /// Run n events, in blocks of the checkpoint interval.
+    void BeamOn(G4int nEvents);
+
+    /// Continue the job saved in a checkpoint file.
+    G4bool Resume(const G4String& filename);
+
+private:
+    /// Run the remaining blocks, done events being already processed.
+    void RunBlocks(G4int done);
+
+    /// Write the checkpoint file (through a temporary file, so that a job
+    /// stopped while writing leaves the previous checkpoint).
+    G4bool Write(G4int done, G4int nextRun);
+
+    /// Read the key=value pairs of a checkpoint file.
+    G4bool Read(const G4String& filename, std::map<G4String, G4String>& values);
+
+    PersistencyManager* fPersistencyManager;
+    CheckpointMessenger* fMessenger;
+
+    G4int fInterval;
+    G4String fFilename;
+
+    /// The events of the job being run
+    G4int fTotalEvents;
+    G4int fFirstEvent;
+    G4int fFirstRun;
+
+    /// The counters of the blocks done so far
+    TG4RunSummary fTotals;
+};
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef CheckpointMessenger_hh
+#define CheckpointMessenger_hh 1
+
+#include "G4UImessenger.hh"
+
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+
+class CheckpointManager;
+
+/// Provide control of the checkpoints of long runs
+class CheckpointMessenger: public G4UImessenger {
+public:
+    CheckpointMessenger(CheckpointManager* checkpointMgr);
+    virtual ~CheckpointMessenger();
+
+    void SetNewValue(G4UIcommand* command,G4String newValues);
+    G4String GetCurrentValue(G4UIcommand* command);
+
+private:
+    CheckpointManager* fCheckpointManager;
+
+    G4UIcommand*               fCheckpointCMD;
+    G4UIcmdWithAnInteger*      fBeamOnCMD;
+    G4UIcmdWithAString*        fResumeCMD;
+};
+#endif
@@ -0,0 +1,44 @@
+#ifndef CrystalShowerSD_h
+#define CrystalShowerSD_h 1
+
+#include "G4VSensitiveDetector.hh"
+#include "G4VGFlashSensitiveDetector.hh"
+
+#include "ScintillationSampler.hh"
+
+class G4Step;
+class G4GFlashSpot;
+class G4VProcess;
+
+/// Sensitive detector of the crystals for the parameterised showers.
+///
+/// The energy spots of GFlash are turned into scintillation photons as the
+/// scintillation process would for the same deposit (yield, resolution
+/// scale, emission spectrum and decay time of the crystal material, no
+/// Birks correction), and pushed on the stack of the event, or kept as a
+/// genstep when the photons are not tracked or generated later (see
+/// GenstepManager).  The
+/// steps of the tracked particles are ignored, they produce their photons
+/// themselves.
+class CrystalShowerSD : public G4VSensitiveDetector, public G4VGFlashSensitiveDetector
+{
+  public:
+
+    CrystalShowerSD(G4String, G4int);
+    virtual ~CrystalShowerSD();
+
+    virtual G4bool ProcessHits(G4Step* , G4TouchableHistory* );
+
+    virtual G4bool ProcessHits(G4GFlashSpot* , G4TouchableHistory* );
+
+  private:
+
+    ScintillationSampler fSampler;
+
+    // The photons are seen as created by the scintillation process
+    const G4VProcess* fScintillation;
+
+    G4int fVerbose;
+};
+
+#endif
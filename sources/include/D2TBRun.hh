@@ -4,6 +4,12 @@
 #include "G4Run.hh"
 #include "globals.hh"
 
+#include <map>
+#include <utility>
+#include <vector>
+
+class TG4RunSummary;
+
 class D2TBRun : public G4Run
 {
 public:
@@ -26,20 +32,67 @@ public:
         fBoundaryAbsorptionCount  += count;
     }
 
+    /// Count a photon detected by a SiPM and bin its arrival time.
+    void AddDetectedPhoton(G4int crystalNo, G4int SiPMNo, G4double time);
+
+    /// Update the running mean and variance of the number of detected
+    /// photons per event (Welford).
+    void AddEventDetectedPhotons(G4int count);
+
+    /// The sub-events tracked by a worker are not counted as events, only
+    /// the events they are merged in.
+    virtual void RecordEvent(const G4Event* event);
+
     virtual void Merge(const G4Run* run);
 
     void EndOfRun();
 
-    G4int GetHitCount() { return fHitCount; }
-    G4int GetPhotonCount_Scint() { return fPhotonCount_Scint; }
-    G4int GetAbsorption() { return fAbsorptionCount; }
-    G4int GetBoundaryAbsorption() { return fBoundaryAbsorptionCount; }
+    G4int GetHitCount() const { return fHitCount; }
+    G4int GetPhotonCount_Scint() const { return fPhotonCount_Scint; }
+    G4int GetAbsorption() const { return fAbsorptionCount; }
+    G4int GetBoundaryAbsorption() const { return fBoundaryAbsorptionCount; }
+
+    /// Statistics of the number of detected photons per event.
+    G4int GetDetectedEvents() const { return fDetectedEvents; }
+    G4double GetDetectedMean() const { return fDetectedMean; }
+    G4double GetDetectedM2() const { return fDetectedM2; }
+    G4double GetDetectedVariance() const;
+
+    /// The number of detected photons per crystal.
+    const std::map<G4int, G4double>& GetCrystalYield() const { return fCrystalYield; }
+
+    /// The arrival time distribution of each (crystal, SiPM), binned from 0
+    /// to GetTimeMax() in GetTimeBins() bins.  The first and last entries are
+    /// the underflow and overflow (same convention as ROOT).
+    typedef std::pair<G4int, G4int> SiPMKey;
+    const std::map<SiPMKey, std::vector<G4double> >& GetArrivalTimes() const { return fArrivalTimes; }
+
+    /// Copy the counters and the statistics in a run summary.
+    void FillSummary(TG4RunSummary& summary) const;
+
+    static G4int GetTimeBins();
+    static G4double GetTimeMax();
 
 private:
     G4int fHitCount;
     G4int fPhotonCount_Scint;
     G4int fAbsorptionCount;
     G4int fBoundaryAbsorptionCount;
+
+    G4int fDetectedEvents;
+    G4double fDetectedMean;
+    G4double fDetectedM2;
+
+    std::map<G4int, G4double> fCrystalYield;
+    std::map<SiPMKey, std::vector<G4double> > fArrivalTimes;
+
+    /// The accumulators of each SiPM in the maps above, indexed by crystal
+    /// and SiPM number so that the hits do not look them up
+    struct SiPMAccumulators {
+        G4double* yield;
+        std::vector<G4double>* bins;
+    };
+    std::vector<SiPMAccumulators> fSiPMIndex;
 };
 
 #endif // D2TBRun_hh
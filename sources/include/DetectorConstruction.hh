@@ -7,14 +7,22 @@
 #include "G4VUserDetectorConstruction.hh"
 #include "globals.hh"
 #include "G4Cache.hh"
+#include "G4ThreeVector.hh"
+
+#include <vector>
 
 class G4LogicalVolume;
 class G4VPhysicalVolume;
 class G4Material;
+class G4MaterialPropertiesTable;
 class DetectorMessenger;
 class G4UnitDefinition;
 class G4Box;
+class G4Region;
+class G4UserLimits;
 class PhotonDetSD;
+class CrystalShowerSD;
+class GFlashShowerModel;
 
 /// Detector construction class to define materials and geometry.
 
@@ -37,6 +45,13 @@ public:
     void SetSiPMDepth(G4double);
     void SetSiPM_PDE(G4double);
 
+    /// Apply the parameters changed since the last update.  Only the volumes
+    /// affected are modified: the SiPM solids and placements for the SiPM
+    /// parameters, the crystals too for the crystal ones, the surface for the
+    /// PDE.  A new number of crystals rebuilds the whole geometry.
+    void UpdateGeometry();
+    G4bool IsModified() const { return fModified != 0; }
+
     G4int GetVerboseLevel() const { return fVerboseLevel; }
     G4int GetSDVerboseLevel() const { return fSDVerboseLevel; }
     G4int GetNCrystal() const { return fNCrystal; }
@@ -47,12 +62,42 @@ public:
     G4double GetSiPM_PDE() const { return fSiPM_PDE; }
     G4double GetCrystalEnd();
 
+    /// The regions of the production cuts: the crystals (with the holes), the
+    /// SiPMs, and the world (the default region).
+    G4Region* GetCrystalRegion() const { return fCrystalRegion; }
+    G4Region* GetSiPMRegion() const { return fSiPMRegion; }
+    G4Region* GetWorldRegion() const;
+
+    /// Kill the optical photons entering the world region.
+    void SetKillPhotonsInWorld(G4bool kill) { fKillPhotonsInWorld = kill; }
+    G4bool GetKillPhotonsInWorld() const { return fKillPhotonsInWorld; }
+
+    /// Kill the other particles in the world volume below this kinetic
+    /// energy (0 to keep them).
+    void SetWorldKillEnergy(G4double);
+    G4double GetWorldKillEnergy() const { return fWorldKillEnergy; }
+
+    /// Parameterise the showers of the electrons and positrons above the
+    /// threshold in the crystal region (GFlash), their energy spots produce
+    /// the scintillation photons.  Set before the initialization.
+    void SetShowerParameterisation(G4bool use) { fShowerParameterisation = use; }
+    G4bool GetShowerParameterisation() const { return fShowerParameterisation; }
+    void SetShowerThreshold(G4double threshold) { fShowerThreshold = threshold; }
+    G4double GetShowerThreshold() const { return fShowerThreshold; }
+
 private:
     // methods
     void UpdateGeometryParameters();
     void DefineMaterials();
     G4VPhysicalVolume* ConstructDetector();
     void BuildCrystalandSiPM();
+    void ConstructRegions();
+    void ConstructShowerModel();
+    G4ThreeVector GetCrystalPosition(G4int iCrystal) const;
+    G4ThreeVector GetHolePosition(G4int irow, G4int iSiPM) const;
+    void UpdateCrystals();
+    void UpdateSiPMs();
+    void UpdatePDE();
 
     void PrintParameters();
 
@@ -80,16 +125,46 @@ private:
     G4int   fVerboseLevel;                 //verbose level
     G4int   fSDVerboseLevel;
 
+    //What was modified since the last update
+    enum { kSurfaceModified = 1, kSiPMModified = 2, kCrystalModified = 4, kLayoutModified = 8 };
+    G4int   fModified;
+
     //Materials
     G4Material* fDefaultMaterial;          //Default material (G4_AIR)
     G4Material* fCrystalMaterial;          //Crystal material (LYSO)
     G4Material* fSiPMMaterial;             //SiPM photocathode material (G4_Si)
+    G4MaterialPropertiesTable* fPhotonDetSurfaceProperty; //Properties of the photocathode surface (PDE)
 
     G4LogicalVolume*   fWorldLogical;      //World logical volume
     G4LogicalVolume*   fCrystalLogical;    //Crystal logical volume
+    G4LogicalVolume*   fSiPMLogical;       //SiPM logical volume
     G4VPhysicalVolume* fWorldPhysical;     //World physical volume (returns from ConstructDetector())
     G4VPhysicalVolume* fCrystalPhysical;   //Crystal physical volume
     G4Cache<PhotonDetSD*> fSD;             //Sensitive G4 detector handle
+
+    //Solids and placements modified in place by UpdateGeometry()
+    G4Box* fCrystalBox;
+    G4Box* fHoleBox;
+    G4Box* fSiPMBox;
+    G4Box* fPhotonDetBox;
+    G4VPhysicalVolume* fPhotonDetPhysical;
+    std::vector<G4VPhysicalVolume*> fCrystalPhysicals;
+    std::vector<G4VPhysicalVolume*> fHolePhysicals;
+    std::vector<G4VPhysicalVolume*> fSiPMPhysicals;
+
+    //Regions and the limits of the world
+    G4Region* fCrystalRegion;
+    G4Region* fSiPMRegion;
+    G4UserLimits* fWorldLimits;            //Minimum kinetic energy in the world volume
+    G4double fWorldKillEnergy;
+    G4bool fKillPhotonsInWorld;
+
+    //Parameterised showers, the model and the sensitive detector of the
+    //crystals are per thread
+    G4bool fShowerParameterisation;
+    G4double fShowerThreshold;
+    G4Cache<CrystalShowerSD*> fShowerSD;
+    G4Cache<GFlashShowerModel*> fShowerModel;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -39,6 +39,11 @@ private:
     G4UIcmdWithADoubleAndUnit*      fSiPMSizeXYCmd;
     G4UIcmdWithADoubleAndUnit*      fSiPMDepthCmd;
     G4UIcmdWithADouble*      fSiPMPDECmd;
+    G4UIcmdWithoutParameter*        fUpdateCmd;
+    G4UIcmdWithABool*               fKillPhotonsInWorldCmd;
+    G4UIcmdWithADoubleAndUnit*      fWorldKillEnergyCmd;
+    G4UIcmdWithABool*               fShowerCmd;
+    G4UIcmdWithADoubleAndUnit*      fShowerThresholdCmd;
 };
 
 
@@ -5,8 +5,11 @@
 #define EventAction_h 1
 
 #include "G4UserEventAction.hh"
+#include "G4Version.hh"
 #include "globals.hh"
 
+#include "PhotonDetHit.hh"
+
 /// Event action class
 ///
 /// In EndOfEventAction(), it prints the accumulated quantities of the energy
@@ -22,6 +25,12 @@ public:
     virtual void  BeginOfEventAction(const G4Event*);
     virtual void    EndOfEventAction(const G4Event*);
 
+    #if G4VERSION_NUMBER >= 1120
+    /// Add the photon detector hits of a sub-event (a bunch of optical
+    /// photons tracked by another thread) to the event it belongs to.
+    virtual void MergeSubEvent(G4Event* masterEvent, const G4Event* subEvent);
+    #endif
+
     void IncHitCount(G4int i = 1){ fHitCount+=i; }
     void IncPhotonCount_Scint() { fPhotonCount_Scint++; }
     void IncAbsorption() { fAbsorptionCount++; }
@@ -33,8 +42,13 @@ public:
     G4int GetBoundaryAbsorptionCount() const { return fBoundaryAbsorptionCount; }
 
 private:
+    /// True on the threads tracking the sub-events (Geant4 11.2).
+    static G4bool IsSubEventWorker();
+
+    /// Mark the hits drawn, one per SiPM with the number of its hits.
+    void MarkSiPMHits(PhotonDetHitsCollection* SiPMHC);
+
     //members
-    G4int fVerboseLevel;
     G4int fPhotonDetCollID;
     G4int fHitCount;
     G4int fPhotonCount_Scint;
@@ -0,0 +1,28 @@
+#ifndef Genstep_hh
+#define Genstep_hh 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+class G4Material;
+
+/// A step which emits scintillation photons (a "genstep"), kept instead of
+/// its photons.  The photons are spread uniformly along the step and over its
+/// duration, their number already includes the Birks quenching and the
+/// fluctuations of the yield.
+struct Genstep
+{
+    G4ThreeVector fStart;
+    G4ThreeVector fEnd;
+    G4double fStartTime;
+    G4double fEndTime;
+    G4double fEnergyDeposit;
+    G4int fNumPhotons;
+    G4int fTrackId;
+    G4int fPDGCode;
+
+    /// The scintillator the photons are emitted in
+    const G4Material* fMaterial;
+};
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef GenstepManager_hh
+#define GenstepManager_hh 1
+
+#include "globals.hh"
+#include "Genstep.hh"
+
+class G4Event;
+class G4Track;
+
+#include <atomic>
+#include <vector>
+
+/// Simulation in two stages: the charged shower, then the optical photons.
+///
+///   - track: the scintillation photons are tracked with the shower (the
+///     default),
+///   - record: the photons are not tracked, each scintillating step is kept
+///     as a genstep and written with the event (TG4Event::Gensteps),
+///   - replay: the gensteps of the events of a recorded output are read and
+///     their photons generated by the stacking action, only the optical
+///     transport is simulated.
+///
+/// The event with a given id replays the recorded event of the same id, so
+/// a scan of the optical parameters (PDE, reflectivity, absorption length)
+/// reuses one recorded sample, the geometry must not change.  The gensteps of
+/// the current event are kept per thread.
+///
+/// With a batch size, the photons are generated lazily when they are tracked
+/// (replayed photons always are, all at once without batch size): the photons of each step are replaced by its genstep, and
+/// the stacking action only turns the gensteps into photon tracks by batches
+/// of this size, once the stack is empty.  The memory held by the photons of
+/// an event then no longer grows with its energy.  The stacking action only
+/// gets a new stage when a track is waiting: the event gets a marker primary,
+/// waiting until the shower is done and dropped then, and the last photon of
+/// each batch waits for the others when some photons are left.
+class GenstepManager
+{
+public:
+    enum Mode { kTrack = 0, kRecord = 1, kReplay = 2 };
+
+    static void SetMode(G4int mode) { fMode = mode; }
+    static G4int GetMode() { return fMode.load(std::memory_order_relaxed); }
+
+    /// The number of photons generated at once from the gensteps (0 to
+    /// stack all the photons of a step as soon as it is done, or all the
+    /// replayed photons at once).
+    static void SetBatchSize(G4int n) { fBatchSize = n; }
+    static G4int GetBatchSize() { return fBatchSize.load(std::memory_order_relaxed); }
+
+    /// Check if the scintillating steps are kept as gensteps instead of
+    /// stacking their photons (to be recorded or generated lazily).
+    static G4bool IsRecording() {
+        G4int mode = GetMode();
+        return mode == kRecord || (mode == kTrack && GetBatchSize() > 0);
+    }
+
+    /// Check if the photons of the gensteps are generated by the stacking
+    /// action (by batches, or all at once when replayed without batch size).
+    static G4bool IsLazy() {
+        G4int mode = GetMode();
+        return mode == kReplay || (mode == kTrack && GetBatchSize() > 0);
+    }
+
+    /// Add the marker primary of the lazy generation to an event (a geantino
+    /// at rest), and check if a track is this marker.
+    static void AddMarker(G4Event* anEvent);
+    static G4bool IsMarker(const G4Track* aTrack);
+
+    /// Convert a mode to and from its name.
+    static G4String GetModeName(G4int mode);
+    static G4int GetModeFromName(const G4String& name);
+
+    /// The gensteps of the current event of this thread.
+    static const std::vector<Genstep>& GetGensteps() { return *GetBuffer(); }
+    static void Record(const Genstep& genstep) { GetBuffer()->push_back(genstep); }
+    static void Clear();
+
+    /// The number of photons of the gensteps of the current event.
+    static G4int GetNumberOfPhotons();
+
+    /// Check if some photons of the gensteps of the current event have not
+    /// been generated yet.
+    static G4bool HasPendingPhotons();
+
+    /// Take up to n of the photons not generated yet of the next genstep,
+    /// null once they were all taken.
+    static const Genstep* TakePhotons(G4int n, G4int& nPhotons);
+
+    /// Open the recorded output replayed (ROOT files, with wildcards).
+    static G4bool SetInput(const G4String& filename);
+    static const G4String& GetInput() { return fInput; }
+
+    /// Read the gensteps of an event of the input as the gensteps of the
+    /// current event, false if the input has no such event.
+    static G4bool ReadEvent(G4int eventId);
+
+private:
+    static std::vector<Genstep>* GetBuffer();
+
+    static std::atomic<G4int> fMode;
+    static std::atomic<G4int> fBatchSize;
+    static G4String fInput;
+
+    static G4ThreadLocal std::vector<Genstep>* fGensteps;
+
+    // The first genstep with photons not generated yet, and the number of
+    // its photons already generated
+    static G4ThreadLocal std::size_t fNextGenstep;
+    static G4ThreadLocal G4int fNextPhoton;
+};
+
+#endif
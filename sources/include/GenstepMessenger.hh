@@ -0,0 +1,25 @@
+#ifndef GenstepMessenger_hh
+#define GenstepMessenger_hh 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+
+/// Provide control of the two stage simulation (recorded gensteps replayed)
+class GenstepMessenger: public G4UImessenger {
+public:
+    GenstepMessenger();
+    virtual ~GenstepMessenger();
+
+    void SetNewValue(G4UIcommand* command,G4String newValues);
+    G4String GetCurrentValue(G4UIcommand* command);
+
+private:
+    G4UIdirectory*             fGenstepDIR;
+    G4UIcmdWithAString*        fModeCMD;
+    G4UIcmdWithAString*        fInputCMD;
+    G4UIcmdWithAnInteger*      fBatchSizeCMD;
+};
+#endif
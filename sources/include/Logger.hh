@@ -0,0 +1,88 @@
+#ifndef Logger_hh
+#define Logger_hh 1
+
+#include "globals.hh"
+
+#include <atomic>
+#include <map>
+#include <sstream>
+
+/// Leveled logging for the user actions.
+///
+/// Messages are collected in a thread local buffer and written to G4cout in
+/// one block by Flush() (called at the end of every event), so that worker
+/// threads do not serialise on the output lock for every line.  The level
+/// check is done in the D2TB_LOG macros before anything is formatted, so a
+/// disabled message costs one relaxed atomic load.
+///
+/// Messages logged with D2TB_LOG_LIMITED are also rate limited: only the
+/// first N messages of a given tag are printed by each thread during a run,
+/// the number of suppressed ones is reported at the end of the run.
+
+class Logger
+{
+public:
+    enum Level { kError = 0, kWarning = 1, kInfo = 2, kDebug = 3 };
+
+    /// Check if messages of this level are printed.
+    static G4bool IsEnabled(Level level) {
+        return level <= fLevel.load(std::memory_order_relaxed);
+    }
+
+    static void SetLevel(G4int level) { fLevel = level; }
+    static G4int GetLevel() { return fLevel; }
+
+    /// Set the number of messages per tag, thread and run that are printed
+    /// by D2TB_LOG_LIMITED (0 means no limit).
+    static void SetRateLimit(G4int n) { fRateLimit = n; }
+    static G4int GetRateLimit() { return fRateLimit; }
+
+    /// Convert a level to and from its name (error, warning, info, debug).
+    static G4String GetLevelName(G4int level);
+    static G4int GetLevelFromName(const G4String& name);
+
+    /// Count a message of the given tag and check the rate limit.
+    static G4bool Allow(const char* tag);
+
+    /// Write the buffered messages of this thread to G4cout.
+    static void Flush();
+
+    /// Reset the rate limit counters of this thread.
+    static void BeginOfRun();
+
+    /// Report the suppressed messages of this thread and flush.
+    static void EndOfRun();
+
+    /// A single message, appended to the thread buffer when destroyed.
+    class Message
+    {
+    public:
+        Message(Level level);
+        ~Message();
+
+        std::ostream& Stream() { return *fStream; }
+
+    private:
+        Level fMessageLevel;
+        std::ostringstream* fStream;
+    };
+
+private:
+    static std::ostringstream* GetBuffer();
+
+    static std::atomic<G4int> fLevel;
+    static std::atomic<G4int> fRateLimit;
+
+    static G4ThreadLocal std::ostringstream* fBuffer;
+    static G4ThreadLocal std::map<const char*, G4int>* fTagCounts;
+};
+
+#define D2TB_LOG(level) \
+    if (!Logger::IsEnabled(Logger::level)) {} \
+    else Logger::Message(Logger::level).Stream()
+
+#define D2TB_LOG_LIMITED(level, tag) \
+    if (!Logger::IsEnabled(Logger::level) || !Logger::Allow(tag)) {} \
+    else Logger::Message(Logger::level).Stream()
+
+#endif
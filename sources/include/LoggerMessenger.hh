@@ -0,0 +1,24 @@
+#ifndef LoggerMessenger_hh
+#define LoggerMessenger_hh 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+
+/// Provide control of the Logger level and rate limit
+class LoggerMessenger: public G4UImessenger {
+public:
+    LoggerMessenger();
+    virtual ~LoggerMessenger();
+
+    void SetNewValue(G4UIcommand* command,G4String newValues);
+    G4String GetCurrentValue(G4UIcommand* command);
+
+private:
+    G4UIdirectory*             fLogDIR;
+    G4UIcmdWithAString*        fLevelCMD;
+    G4UIcmdWithAnInteger*      fRateLimitCMD;
+};
+#endif
@@ -0,0 +1,37 @@
+#ifndef MultiProcessRunner_hh
+#define MultiProcessRunner_hh 1
+
+#include "globals.hh"
+
+class PersistencyManager;
+
+/// Run the events in several processes forked after the initialization.
+///
+/// This is the fallback when Geant4 is built without multi-threading (or
+/// when it must not be used).  The physics tables are built before forking,
+/// so they are shared (copy on write) by the processes.  Each process runs a
+/// disjoint range of event ids (and so of seeds, see SeedManager) and writes
+/// its own output file, name_p<k>.root, which are merged by the parent once
+/// all the processes are done.
+class MultiProcessRunner
+{
+public:
+    MultiProcessRunner(PersistencyManager* persistencyManager, G4int nProcesses);
+    virtual ~MultiProcessRunner();
+
+    /// Run nEvents events split between the processes and merge the outputs
+    /// in the output file.  Only the parent process returns.
+    G4bool BeamOn(G4int nEvents, const G4String& output);
+
+    /// The output file of the k-th process.
+    static G4String GetProcessFilename(const G4String& output, G4int k);
+
+private:
+    /// Run the events of one process and exit.
+    void RunProcess(G4int k, G4int first, G4int nEvents, const G4String& output);
+
+    PersistencyManager* fPersistencyManager;
+    G4int fProcesses;
+};
+
+#endif
@@ -8,16 +8,21 @@
 
 #include <vector>
 #include <map>
+#include <set>
 
 class G4Event;
 class G4Run;
 class G4VPhysicalVolume;
 class G4VHitsCollection;
+class G4VTrajectory;
+class TG4RunSummary;
 
 class PersistencyMessenger;
 
 class PersistencyManager : public G4VPersistencyManager {
 public:
+    /// The decimation of the points of the saved trajectories.
+    enum Decimation { kNoDecimation = 0, kDouglasPeucker, kNthPoint };
 
     PersistencyManager();
     virtual ~PersistencyManager();
@@ -47,6 +52,72 @@ public:
     /// Return the output file name.
     virtual G4String GetFilename(void) const {return fFilename;}
 
+    /// Flush the output to a consistent point, so that it can be reopened
+    /// with Reopen if the job is stopped.
+    virtual G4bool Checkpoint(void) {return false;}
+
+    /// Store the summary of a job run in checkpointed blocks, once it is
+    /// complete (the blocks only write their histograms).
+    virtual G4bool StoreSummary(const TG4RunSummary&) {return false;}
+
+    /// Reopen an output (and the given numbered file of a rotated output)
+    /// to append to it.  The events written after the first eventsInFile of
+    /// this file, and the later numbered files, are dropped (a negative
+    /// count keeps all the events).
+    virtual G4bool Reopen(G4String filename, G4int, G4int) {
+        SetFilename(filename);
+        return false;
+    }
+
+    /// The index of the numbered file currently written (0 for the file that
+    /// was opened).
+    virtual G4int GetFileIndex(void) const {return 0;}
+
+    /// The number of events written to the current file.
+    virtual G4int GetEventsInFile(void) const {return 0;}
+
+    /// Only let the trees be saved by Checkpoint, the data written after the
+    /// last checkpoint are then ignored when the output is reopened.
+    void SetCheckpointing(G4bool enable) {fCheckpointing = enable;}
+    G4bool GetCheckpointing(void) const {return fCheckpointing;}
+
+    /// Set the number of events after which a new output file is started
+    /// (0 means no limit).
+    void SetMaxEventsPerFile(G4int n) {fMaxEventsPerFile = n;}
+    G4int GetMaxEventsPerFile(void) const {return fMaxEventsPerFile;}
+
+    /// Set the size (in bytes) after which a new output file is started (0
+    /// means no limit).
+    void SetMaxFileSize(G4double bytes) {fMaxFileSize = bytes;}
+    G4double GetMaxFileSize(void) const {return fMaxFileSize;}
+
+    /// Only write the run summaries and histograms, not the event tree.
+    void SetReducedOutput(G4bool reduced) {fReducedOutput = reduced;}
+    G4bool GetReducedOutput(void) const {return fReducedOutput;}
+
+    /// Save the trajectories of the events (they must be stored by the
+    /// tracking, see /tracking/storeTrajectory).
+    void SetSaveTrajectories(G4bool save) {fSaveTrajectories = save;}
+    G4bool GetSaveTrajectories(void) const {return fSaveTrajectories;}
+
+    /// Set how the points of the saved trajectories are decimated: all the
+    /// points are kept, or the ones needed to stay within the tolerance of
+    /// the full trajectory (Douglas-Peucker), or every n-th point.  The
+    /// first and last points are always kept.
+    void SetTrajectoryDecimation(G4int decimation) {fTrajectoryDecimation = decimation;}
+    G4int GetTrajectoryDecimation(void) const {return fTrajectoryDecimation;}
+
+    void SetTrajectoryTolerance(G4double tolerance) {fTrajectoryTolerance = tolerance;}
+    G4double GetTrajectoryTolerance(void) const {return fTrajectoryTolerance;}
+
+    void SetTrajectoryStride(G4int stride) {fTrajectoryStride = stride;}
+    G4int GetTrajectoryStride(void) const {return fTrajectoryStride;}
+
+    /// Only save the trajectories of these particles (all of them if the
+    /// set is empty).
+    void SetTrajectoryParticles(const std::set<G4String>& particles) {fTrajectoryParticles = particles;}
+    const std::set<G4String>& GetTrajectoryParticles(void) const {return fTrajectoryParticles;}
+
 protected:
     /// Set the output filename.  This can be used by the derived classes to
     /// inform the base class of the output file name.
@@ -60,6 +131,29 @@ protected:
     /// A summary of the primary vertices in the event.
     TG4Event fEventSummary;
 
+    /// The maximum number of events written to one output file.
+    G4int fMaxEventsPerFile;
+
+    /// The maximum size of one output file in bytes.
+    G4double fMaxFileSize;
+
+    /// Write only the per run reductions.
+    G4bool fReducedOutput;
+
+    /// The trees are only saved at checkpoints.
+    G4bool fCheckpointing;
+
+    /// Save the trajectories of the events.
+    G4bool fSaveTrajectories;
+
+    /// The decimation of the trajectory points and its parameters.
+    G4int fTrajectoryDecimation;
+    G4double fTrajectoryTolerance;
+    G4int fTrajectoryStride;
+
+    /// The particles whose trajectories are saved.
+    std::set<G4String> fTrajectoryParticles;
+
 private:
 
     /// sensitive detector.
@@ -70,6 +164,17 @@ private:
     void SummarizeHits(TG4PhotonDetHitContainer& pHits,
     G4VHitsCollection* hits);
 
+    /// Fill the trajectories of the event summary.
+    void SummarizeTrajectories(TG4TrajectoryContainer& dest,
+    const G4Event* event);
+
+    /// Fill the gensteps recorded in the event.
+    void SummarizeGensteps(TG4GenstepContainer& dest);
+
+    /// Fill the packed coordinates of the points kept of a trajectory.
+    void DecimatePoints(std::vector<Float_t>& dest,
+    const G4VTrajectory* trajectory) const;
+
     /// The filename of the output file.
     G4String fFilename;
 
@@ -6,6 +6,10 @@
 class G4UIdirectory;
 class G4UIcmdWithoutParameter;
 class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithABool;
 
 class PersistencyManager;
 
@@ -23,6 +27,16 @@ private:
     G4UIdirectory*             fPersistencyDIR;
     G4UIcmdWithAString*        fOpenCMD;
     G4UIcmdWithoutParameter*   fCloseCMD;
+    G4UIcmdWithAnInteger*      fMaxEventsCMD;
+    G4UIcmdWithADouble*        fMaxSizeCMD;
+    G4UIcmdWithAString*        fModeCMD;
+
+    G4UIdirectory*             fTrajectoryDIR;
+    G4UIcmdWithABool*          fTrajectorySaveCMD;
+    G4UIcmdWithAString*        fTrajectoryDecimationCMD;
+    G4UIcmdWithADoubleAndUnit* fTrajectoryToleranceCMD;
+    G4UIcmdWithAnInteger*      fTrajectoryStrideCMD;
+    G4UIcmdWithAString*        fTrajectoryParticlesCMD;
 
 };
 #endif
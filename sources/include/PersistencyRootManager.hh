@@ -8,8 +8,10 @@
 class TFile;
 class TTree;
 class TGeoManager;
+class D2TBRun;
 
 #include "PersistencyManager.hh"
+#include "TG4RunSummary.hh"
 
 class PersistencyRootManager : public PersistencyManager
 {
@@ -32,14 +34,74 @@ public:
     virtual G4bool Open(G4String dbname);
     virtual G4bool Close(void);
 
+    virtual G4bool Checkpoint(void);
+    virtual G4bool StoreSummary(const TG4RunSummary& summary);
+    virtual G4bool Reopen(G4String filename, G4int fileIndex, G4int eventsInFile);
+    virtual G4int GetFileIndex(void) const {return fFileIndex;}
+    virtual G4int GetEventsInFile(void) const {return fEventsInFile;}
+
+    /// Return the name of the file currently being written.  This differs
+    /// from GetFilename() once the output has been rotated.
+    G4String GetCurrentFilename(void) const;
+
 private:
 
+    /// Open one output file.  The trees already in the file are reused when
+    /// it is opened in UPDATE mode.
+    G4bool OpenFile(G4String filename, const char* option = "RECREATE");
+
+    /// Create the event tree in the current file.  This is done with the
+    /// first event so that the reduced output has no event tree.
+    void CreateEventTree(void);
+
+    /// Bound the size of the baskets of the event tree kept in memory when
+    /// the files have a size limit, since they are not counted in its size.
+    void LimitBufferedBytes(void);
+
+    /// Keep only the first n events of the event tree of the current file.
+    /// A file closed by a rotation holds the events written after the last
+    /// checkpoint, they are run again when the job is resumed.
+    G4bool TruncateEventTree(Long64_t nEvents);
+
+    /// Write the per run histograms in the Run_<id> directory.
+    void WriteRunHistograms(const D2TBRun* run);
+
+    /// Write the run metadata and the event tree, and close the current file.
+    G4bool CloseFile(void);
+
+    /// Close the current file and continue in the next numbered file.
+    G4bool Rotate(void);
+
+    /// Check if the current file reached the configured event count or size.
+    G4bool NeedsRotation(void) const;
+
+    /// Build the name of the n-th output file (name_NNNN.root).
+    G4String GetChunkFilename(int index) const;
+
 private:
 
     TFile *fOutput;
     TTree *fEventTree;
+    TTree *fRunTree;
     int fEventsNotSaved;
 
+    /// The summary of the last run.
+    TG4RunSummary fRunSummary;
+
+    /// The addresses given to the branches of the trees.
+    TG4Event* fEventPointer;
+    TG4RunSummary* fRunPointer;
+
+    /// The index of the current output file (0 for the file that was opened).
+    int fFileIndex;
+
+    /// The number of events written to the current output file.
+    int fEventsInFile;
+
+    /// The first and last event written to the current output file.
+    int fFirstEventId;
+    int fLastEventId;
+
 };
 
 #endif
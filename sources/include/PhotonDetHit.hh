@@ -57,6 +57,13 @@ public:
     inline void SetSiPMNo(G4int n) { fSiPMNo = n; }
     inline G4int GetSiPMNo() { return fSiPMNo; }
 
+    /// The hits are drawn as one marker per SiPM, on one of its hits, sized
+    /// and coloured by the number of hits of the SiPM (as a fraction of the
+    /// SiPM with the most hits of the event).  The other hits of the SiPM
+    /// have no hit to draw.
+    inline void SetSiPMHits(G4int n, G4double fraction) { fSiPMHits = n; fSiPMHitFraction = fraction; }
+    inline G4int GetSiPMHits() const { return fSiPMHits; }
+
     virtual void Print();
 
 private:
@@ -75,6 +82,9 @@ private:
     G4int fCrystalNo;
     //Number of the SiPM volume
     G4int fSiPMNo;
+    //Number of hits of the SiPM drawn with this hit
+    G4int fSiPMHits;
+    G4double fSiPMHitFraction;
 };
 
 //--------------------------------------------------
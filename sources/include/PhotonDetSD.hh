@@ -29,6 +29,9 @@ class PhotonDetSD : public G4VSensitiveDetector
 
     PhotonDetHitsCollection* fPhotonDetHitCollection;
     G4int fVerbose;
+
+    //Number of hits of the previous event, reserved in the next collection
+    G4int fExpectedHits;
 };
 
 #endif
@@ -4,12 +4,15 @@
 #include "globals.hh"
 #include "G4VUserPhysicsList.hh"
 
+#include <map>
+
 class PhysicsListMessenger;
 
 class G4Scintillation;
 class G4OpAbsorption;
 class G4OpRayleigh;
 class G4OpBoundaryProcess;
+class G4VPhysicsConstructor;
 
 class StepMax;
 
@@ -28,29 +31,76 @@ public:
 
     virtual void SetCuts();
 
+    /// Delete the EM constructor of a worker thread.
+    virtual void TerminateWorker();
+
     //these methods Construct physics processes and register them
     void ConstructDecay();
     void ConstructEM();
     void ConstructOp();
     void AddStepMax();
+    void AddParameterisation();
     void AddLimiters();
 
     //for the Messenger
     void SetVerbose(G4int);
     void SetStepMax(G4double);
 
+    /// Select the EM processes (before the initialization): "local" for the
+    /// minimal set of this list, or one of the Geant4 EM constructors
+    /// ("opt0", "opt1", "opt3", "opt4", "livermore", "penelope").  The optical
+    /// processes do not depend on it.
+    void SetEmOption(const G4String& option) { fEmOption = option; }
+    const G4String& GetEmOption() const { return fEmOption; }
+
+    /// Set the step limit of a region (by its name), and the fraction of the
+    /// range the steps are limited to in this region (see StepMax).
+    void SetRegionStepMax(const G4String& region, G4double);
+    void SetStepMaxRangeFraction(const G4String& region, G4double);
+
+    /// Set the production cut of a region (by its name), instead of the
+    /// default cut.  It is applied at once if the region exists, else when
+    /// the cuts are set at the initialization.
+    void SetRegionCut(const G4String& region, G4double cut);
+    const std::map<G4String, G4double>& GetRegionCuts() const { return fRegionCuts; }
+
+    /// Cache the physics tables in a directory (empty to disable).  The
+    /// tables of each configuration (materials, cuts and processes) are kept
+    /// in a sub-directory named after a hash of the configuration, they are
+    /// retrieved instead of built when it exists.
+    void SetTableCache(const G4String& directory) { fTableCache = directory; }
+    const G4String& GetTableCache() const { return fTableCache; }
+
+    /// Store the tables built by the master if the cache did not have them
+    /// (called once the tables are built, at the start of the run).
+    void StoreTableCache();
+
 private:
 
     /// The messenger to control this class.
     PhysicsListMessenger* fMessenger;
     StepMax* fStepMaxProcess;
     G4double fDefaultCutValue;
+    G4String fEmOption;
+
+    /// The production cuts of the regions which have their own.
+    std::map<G4String, G4double> fRegionCuts;
+    void ApplyRegionCuts();
+
+    /// Describe the configuration the physics tables depend on.
+    G4String GetTableCacheKey() const;
+
+    G4String fTableCache;
+    G4String fTableCacheKey;
+    G4String fTableCachePath;
+    G4bool fStoreTableCache;
 
     static G4ThreadLocal G4int fVerboseLevel;
     static G4ThreadLocal G4Scintillation* fScintillationProcess;
     static G4ThreadLocal G4OpAbsorption* fAbsorptionProcess;
     static G4ThreadLocal G4OpRayleigh* fRayleighScatteringProcess;
     static G4ThreadLocal G4OpBoundaryProcess* fBoundaryProcess;
+    static G4ThreadLocal G4VPhysicsConstructor* fEmPhysics;
 
 };
 
@@ -9,6 +9,8 @@ class PhysicsList;
 class G4UIdirectory;
 class G4UIcmdWithAnInteger;
 class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithAString;
+class G4UIcommand;
 
 /// Provide control of the physics list and cut parameters
 class PhysicsListMessenger : public G4UImessenger
@@ -26,6 +28,11 @@ private:
     G4UIdirectory* fDirectory;
     G4UIcmdWithAnInteger* fVerboseCmd;
     G4UIcmdWithADoubleAndUnit* fStepMaxSizeCmd;
+    G4UIcmdWithAString* fTableCacheCmd;
+    G4UIcmdWithAString* fEmCmd;
+    G4UIcommand* fRegionCutCmd;
+    G4UIcommand* fRegionStepMaxCmd;
+    G4UIcommand* fRangeFractionCmd;
 
 };
 
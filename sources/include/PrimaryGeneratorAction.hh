@@ -17,6 +17,10 @@ class G4Event;
 /// perpendicular to the input face. The type of the particle
 /// can be changed via the G4 build-in commands of G4ParticleGun class
 /// (see the macros provided with this example).
+///
+/// When recorded gensteps are replayed (/d2tb/genstep/mode replay), the
+/// gensteps of the event are read instead, and the event only gets the
+/// marker primary: the stacking action generates their photons.
 
 class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 {
@@ -30,6 +34,8 @@ public:
   void SetRandomFlag(G4bool value);
 
 private:
+  void GeneratePhotons(G4Event* event);
+
   G4ParticleGun*            fG4ParticleGun;  // G4 particle gun
   G4GeneralParticleSource*  fGPSParticleGun; // G4 GPS particle gun
 };
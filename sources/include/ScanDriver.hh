@@ -0,0 +1,71 @@
+#ifndef ScanDriver_hh
+#define ScanDriver_hh 1
+
+#include "globals.hh"
+
+#include <map>
+#include <vector>
+
+class DetectorConstruction;
+class ScanMessenger;
+
+/// Run a grid of detector parameters in one process.
+///
+/// The physics is initialized once, each point of the grid only changes the
+/// parameters that differ from the previous point and runs a number of events
+/// with them.  The points are ordered so that the parameters which are the
+/// most expensive to change (the ones rebuilding the crystals) vary the
+/// slowest and the PDE, which is only a surface property, the fastest.  One
+/// line per point is written in a CSV file with the statistics of its run.
+class ScanDriver
+{
+public:
+    /// The parameters of the scan, from the slowest to the fastest varying.
+    enum Parameter { kNCrystal = 0, kCrystalSizeXY, kCrystalDepth,
+        kSiPMSizeXY, kSiPMDepth, kSiPM_PDE, kNParameters };
+
+    ScanDriver(DetectorConstruction* detector);
+    virtual ~ScanDriver();
+
+    /// Add the values of a parameter to the grid (replacing the previous ones
+    /// of this parameter).  Lengths are in Geant4 units.
+    G4bool AddParameter(const G4String& name, const std::vector<G4double>& values);
+
+    /// Remove all the parameters of the grid.
+    void Clear() { fGrid.clear(); }
+
+    /// The number of events run at each point.
+    void SetEventsPerPoint(G4int n) { fEventsPerPoint = n; }
+    G4int GetEventsPerPoint() const { return fEventsPerPoint; }
+
+    /// The CSV file of the results.
+    void SetFilename(const G4String& filename) { fFilename = filename; }
+    const G4String& GetFilename() const { return fFilename; }
+
+    /// The number of points of the grid.
+    G4int GetNumberOfPoints() const;
+
+    /// Run all the points of the grid.
+    void Run();
+
+    /// The name used in the commands and in the CSV header of a parameter,
+    /// and the unit category of its values ("" if it has no unit).
+    static G4String GetParameterName(G4int parameter);
+    static G4String GetUnitCategory(G4int parameter);
+    static G4int GetParameterFromName(const G4String& name);
+
+private:
+    G4double GetValue(G4int parameter) const;
+    void SetValue(G4int parameter, G4double value);
+
+    DetectorConstruction* fDetector;
+    ScanMessenger* fMessenger;
+
+    /// The values of each parameter of the grid
+    std::map<G4int, std::vector<G4double> > fGrid;
+
+    G4int fEventsPerPoint;
+    G4String fFilename;
+};
+
+#endif
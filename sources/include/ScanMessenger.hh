@@ -0,0 +1,32 @@
+#ifndef ScanMessenger_hh
+#define ScanMessenger_hh 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithoutParameter;
+
+class ScanDriver;
+
+/// Provide control of the parameter scans
+class ScanMessenger: public G4UImessenger {
+public:
+    ScanMessenger(ScanDriver* scanDriver);
+    virtual ~ScanMessenger();
+
+    void SetNewValue(G4UIcommand* command,G4String newValues);
+    G4String GetCurrentValue(G4UIcommand* command);
+
+private:
+    ScanDriver* fScanDriver;
+
+    G4UIdirectory*             fScanDIR;
+    G4UIcmdWithAString*        fAddCMD;
+    G4UIcmdWithoutParameter*   fClearCMD;
+    G4UIcmdWithAnInteger*      fEventsCMD;
+    G4UIcmdWithAString*        fOutputCMD;
+    G4UIcmdWithoutParameter*   fRunCMD;
+};
+#endif
@@ -0,0 +1,68 @@
+#ifndef ScintillationSampler_hh
+#define ScintillationSampler_hh 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <map>
+#include <vector>
+
+class G4Material;
+struct Genstep;
+
+/// Sample the scintillation photons of a material as G4Scintillation does
+/// for a single component: yield and resolution scale, emission spectrum
+/// (FASTCOMPONENT) and exponential decay (FASTTIMECONSTANT).  The properties
+/// of each material are read once, an instance is used by one thread.
+class ScintillationSampler
+{
+public:
+    /// The scintillation properties of a material.
+    struct Emission {
+        G4double fYield;
+        G4double fResolutionScale;
+        G4double fDecayTime;
+
+        // The cumulative emission spectrum
+        std::vector<G4double> fEnergy;
+        std::vector<G4double> fIntegral;
+    };
+
+    /// A photon emitted by a genstep.
+    struct Photon {
+        G4ThreeVector fPosition;
+        G4double fTime;
+        G4double fEnergy;
+        G4ThreeVector fDirection;
+        G4ThreeVector fPolarization;
+    };
+
+    ScintillationSampler();
+    ~ScintillationSampler();
+
+    /// The emission of a material, null if it does not scintillate.
+    const Emission* GetEmission(const G4Material* material);
+
+    /// The number of photons of an energy deposit (without Birks quenching),
+    /// with the fluctuations of G4Scintillation.
+    G4int SampleNumberOfPhotons(const Emission& emission, G4double edep) const;
+
+    /// The energy of a photon from the emission spectrum.
+    G4double SampleEnergy(const Emission& emission) const;
+
+    /// The delay of the emission after the deposit.
+    G4double SampleDelay(const Emission& emission) const;
+
+    /// An isotropic direction and a random linear polarization perpendicular
+    /// to it.
+    static void SampleDirection(G4ThreeVector& direction, G4ThreeVector& polarization);
+
+    /// One of the photons of a genstep: at a uniform point of the step, at
+    /// the time of this point plus the decay delay.
+    void SamplePhoton(const Emission& emission, const Genstep& genstep, Photon& photon) const;
+
+private:
+    std::map<const G4Material*, Emission> fEmissions;
+};
+
+#endif
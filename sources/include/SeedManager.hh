@@ -0,0 +1,46 @@
+#ifndef SeedManager_hh
+#define SeedManager_hh 1
+
+#include "globals.hh"
+
+#include <atomic>
+
+class G4Event;
+
+/// Deterministic seeding of the events.
+///
+/// The random engine is reseeded at the start of every event with seeds
+/// derived (by hashing) from a master seed, the run id and the event id, so
+/// an event gives the same result whatever the thread that processes it, the
+/// number of threads or the process it runs in.  When the output of a run is
+/// split in several processes, each one is given the id of its first event so
+/// that the events keep the ids (and the seeds) they would have in a single
+/// process.
+class SeedManager
+{
+public:
+    /// Set the master seed (0 means a seed is chosen from the time at the
+    /// start of the next run).
+    static void SetMasterSeed(G4long seed) { fMasterSeed = seed; }
+    static G4long GetMasterSeed() { return fMasterSeed; }
+
+    /// Set the id given to the first event of a run.
+    static void SetFirstEvent(G4int id) { fFirstEvent = id; }
+    static G4int GetFirstEvent() { return fFirstEvent; }
+
+    /// The id of an event including the first event offset.
+    static G4int GetEventId(const G4Event* event);
+
+    /// Choose the master seed if it was not set and print it.  This is
+    /// called by the master at the start of each run.
+    static void BeginOfRun();
+
+    /// Reseed the random engine of this thread for the given event.
+    static void SeedEvent(const G4Event* event);
+
+private:
+    static std::atomic<G4long> fMasterSeed;
+    static std::atomic<G4int> fFirstEvent;
+};
+
+#endif
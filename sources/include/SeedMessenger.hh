@@ -0,0 +1,23 @@
+#ifndef SeedMessenger_hh
+#define SeedMessenger_hh 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithAnInteger;
+
+/// Provide control of the master seed and of the first event id
+class SeedMessenger: public G4UImessenger {
+public:
+    SeedMessenger();
+    virtual ~SeedMessenger();
+
+    void SetNewValue(G4UIcommand* command,G4String newValues);
+    G4String GetCurrentValue(G4UIcommand* command);
+
+private:
+    G4UIdirectory*             fRunDIR;
+    G4UIcmdWithAnInteger*      fSeedCMD;
+    G4UIcmdWithAnInteger*      fFirstEventCMD;
+};
+#endif
@@ -9,9 +9,13 @@
 #define StackingAction_h 1
 
 #include "G4UserStackingAction.hh"
+#include "G4TrackVector.hh"
 #include "globals.hh"
 
+#include "ScintillationSampler.hh"
+
 class EventAction;
+class G4VProcess;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -26,9 +30,35 @@ public:
     virtual void NewStage();
     virtual void PrepareNewEvent();
 
+    /// Send the scintillation photons to other threads as sub-events of
+    /// this size (Geant4 >= 11.2 sub-event run manager, 0 to disable).
+    static void SetSubEventSize(G4int n) { fSubEventSize = n; }
+    static G4int GetSubEventSize() { return fSubEventSize; }
+
 private:
+    /// Generate the next batch of photons of the pending gensteps
+    /// (/d2tb/genstep/batchSize).
+    void GeneratePhotons();
+
     EventAction* fEventAction;
     G4int fScintillationCounter;
+
+    ScintillationSampler fSampler;
+    G4TrackVector fBatch;
+    G4bool fGenerating;
+
+    // Set while the waiting tracks are classified again at a new stage
+    G4bool fNewStage;
+    // The photon of the batch stacked as waiting, to start the next stage
+    const G4Track* fDeferred;
+    // The photon of the batch kept in the event when the others are sent to
+    // sub-events
+    const G4Track* fLocal;
+
+    // The generated photons are seen as created by the scintillation process
+    const G4VProcess* fScintillation;
+
+    static G4int fSubEventSize;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
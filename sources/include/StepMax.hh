@@ -7,6 +7,11 @@
 #include "G4VDiscreteProcess.hh"
 #include "G4ParticleDefinition.hh"
 
+#include <atomic>
+#include <map>
+
+class G4Region;
+
 class StepMax : public G4VDiscreteProcess
 {
   public:
@@ -22,6 +27,14 @@ class StepMax : public G4VDiscreteProcess
 
     G4double GetStepMax() {return fMaxChargedStep;};
 
+    // Limit of the steps in a region (by its name) instead of the default
+    // one, 0 for no limit
+    void SetStepMax(const G4String& region, G4double);
+
+    // Limit the steps in a region to this fraction of the range of the
+    // particle, but not below the fixed limit of the region (0 to disable)
+    void SetRangeFraction(const G4String& region, G4double);
+
     virtual G4double PostStepGetPhysicalInteractionLength(const G4Track& track, G4double previousStepSize, G4ForceCondition* condition);
 
     virtual G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
@@ -36,10 +49,27 @@ class StepMax : public G4VDiscreteProcess
     StepMax & operator=(const StepMax &right);
     StepMax(const StepMax&);
 
+    // Look up the limits of the region of the current track
+    void UpdateCache(const G4Region*);
+
   private:
 
     G4double fMaxChargedStep;
 
+    std::map<G4String, G4double> fRegionStepMax;
+    std::map<G4String, G4double> fRangeFraction;
+
+    // Changed with the limits, to invalidate the per thread caches
+    std::atomic<G4int> fVersion;
+
+    // The limits of the last region seen by the thread, the tracks only
+    // rarely change region between two steps
+    static G4ThreadLocal const StepMax* fCachedProcess;
+    static G4ThreadLocal const G4Region* fCachedRegion;
+    static G4ThreadLocal G4int fCachedVersion;
+    static G4ThreadLocal G4double fCachedStepMax;
+    static G4ThreadLocal G4double fCachedRangeFraction;
+
 };
 
 #endif
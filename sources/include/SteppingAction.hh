@@ -32,6 +32,9 @@ public:
 
 private:
 
+    /// Keep a step which emitted scintillation photons as a genstep.
+    void RecordGenstep(const G4Step* theStep);
+
     inline void ResetCounters()
     {
         fCounterBounce = 0;
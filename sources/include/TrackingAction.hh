@@ -24,7 +24,9 @@ public:
     virtual void PostUserTrackingAction(const G4Track* aTrack);
 
 private:
-
+    // The /tracking/storeTrajectory value, switched off for the tracks
+    // excluded by the TrajectoryPolicy and restored at their end
+    G4int fStoreTrajectory;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -26,6 +26,18 @@ public:
     Trajectory(Trajectory &);
     virtual ~Trajectory();
 
+    /// Build the trajectory of a track at its end, from its vertex and the
+    /// positions recorded after each of its steps.
+    static Trajectory* FromPath(const G4Track* aTrack, const std::vector<G4ThreeVector>& path);
+
+    /// Mark in keep (sized as points, with its first and last entries set)
+    /// the points which keep a polyline within a tolerance of all of them.
+    static void DouglasPeucker(const std::vector<G4ThreeVector>& points,
+                               G4double tolerance, std::vector<char>& keep);
+
+    /// Draw the trajectory when it was selected for drawing.  Its polyline
+    /// is decimated with the tolerance of the trajectory policy, and built
+    /// only once for all the redraws of the event.
     virtual void DrawTrajectory() const;
 
     inline void* operator new(size_t);
@@ -41,6 +53,7 @@ private:
 
     G4ParticleDefinition* fParticleDefinition;
 
+    mutable G4Polyline* fPolyline;
 };
 
 extern G4ThreadLocal G4Allocator<Trajectory>* TrajectoryAllocator;
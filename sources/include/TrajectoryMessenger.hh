@@ -0,0 +1,27 @@
+#ifndef TrajectoryMessenger_hh
+#define TrajectoryMessenger_hh 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+
+/// Provide control of the tracks which get a trajectory and of the ones drawn
+class TrajectoryMessenger: public G4UImessenger {
+public:
+    TrajectoryMessenger();
+    virtual ~TrajectoryMessenger();
+
+    void SetNewValue(G4UIcommand* command,G4String newValues);
+    G4String GetCurrentValue(G4UIcommand* command);
+
+private:
+    G4UIdirectory*             fTrajectoryDIR;
+    G4UIcmdWithAString*        fStoreCMD;
+    G4UIcmdWithAnInteger*      fDrawPhotonsCMD;
+    G4UIcmdWithAnInteger*      fMaxDrawnCMD;
+    G4UIcmdWithADoubleAndUnit* fDrawToleranceCMD;
+};
+#endif
@@ -0,0 +1,89 @@
+#ifndef TrajectoryPolicy_hh
+#define TrajectoryPolicy_hh 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <atomic>
+#include <vector>
+
+class G4Track;
+
+/// Select the tracks which get a trajectory when the trajectories are stored
+/// (/tracking/storeTrajectory, set by /vis/scene/add/trajectories).
+///
+///   - none: no trajectory at all,
+///   - charged: the charged particles only,
+///   - detectedPhotons: all the particles but the optical photons, and the
+///     optical photons detected by a SiPM,
+///   - all: every track.
+///
+/// The excluded tracks get no trajectory and no trajectory point.  Since a
+/// photon is only known to be detected at the end of its track, its path is
+/// recorded in a buffer of the thread, reused from photon to photon, and its
+/// trajectory is only built from it when the photon is detected.
+///
+/// Only a sample of the trajectories kept is drawn, so that the viewer stays
+/// responsive with the photons of a high energy event: one in n of the
+/// optical photons, and at most a number of trajectories per event (in the
+/// order they are completed).  The sample is taken with counters, not with
+/// the random engine, so the drawing does not change the events.
+class TrajectoryPolicy
+{
+public:
+    enum Mode { kNone = 0, kCharged = 1, kDetectedPhotons = 2, kAll = 3 };
+
+    static void SetMode(G4int mode) { fMode = mode; }
+    static G4int GetMode() { return fMode; }
+
+    /// Convert a mode to and from its name.
+    static G4String GetModeName(G4int mode);
+    static G4int GetModeFromName(const G4String& name);
+
+    /// Check if a trajectory is created at the start of the track.
+    static G4bool IsSelected(const G4Track* aTrack);
+
+    /// Check if the path of the track is recorded until it is known whether
+    /// it gets a trajectory.
+    static G4bool IsDeferred(const G4Track* aTrack);
+
+    /// Draw one in n of the optical photons which keep a trajectory.
+    static void SetPhotonDrawStride(G4int n) { fPhotonDrawStride = n; }
+    static G4int GetPhotonDrawStride() { return fPhotonDrawStride; }
+
+    /// The maximum number of trajectories drawn per event (0 for no limit).
+    static void SetMaxDrawn(G4int n) { fMaxDrawn = n; }
+    static G4int GetMaxDrawn() { return fMaxDrawn; }
+
+    /// The tolerance of the decimation of the points of a trajectory drawn.
+    static void SetDrawTolerance(G4double tolerance) { fDrawTolerance = tolerance; }
+    static G4double GetDrawTolerance() { return fDrawTolerance; }
+
+    /// Reset the counters of the trajectories drawn at the start of an event.
+    static void StartEvent();
+
+    /// Check if the trajectory kept for a track is drawn.
+    static G4bool IsDrawn(const G4Track* aTrack);
+
+    /// The path of the current track of this thread (the positions after
+    /// each step) while it is recorded.
+    static void StartPath();
+    static void StopPath();
+    static G4bool IsRecordingPath() { return fRecording; }
+    static void RecordPoint(const G4ThreeVector& position) { fPath->push_back(position); }
+    static const std::vector<G4ThreeVector>& GetPath() { return *fPath; }
+
+private:
+    static std::atomic<G4int> fMode;
+    static std::atomic<G4int> fPhotonDrawStride;
+    static std::atomic<G4int> fMaxDrawn;
+    static std::atomic<G4double> fDrawTolerance;
+
+    static G4ThreadLocal G4int fPhotonsKept;
+    static G4ThreadLocal G4int fDrawn;
+
+    static G4ThreadLocal G4bool fRecording;
+    static G4ThreadLocal std::vector<G4ThreeVector>* fPath;
+};
+
+#endif
@@ -4,6 +4,7 @@
 #include "G4VUserTrackInformation.hh"
 
 #include "G4ThreeVector.hh"
+#include "G4Allocator.hh"
 
 enum TrackStatus {
     active=1, hitSiPM=2, absorbed=4, boundaryAbsorbed=8,
@@ -30,6 +31,10 @@ public:
     UserTrackInformation();
     virtual ~UserTrackInformation();
 
+    //One is created for each track, they are taken from a per thread pool
+    inline void *operator new(size_t);
+    inline void operator delete(void *aTrackInformation);
+
     const G4ThreeVector& GetExitPosition() const { return fExitPosition; }
     void SetExitPosition (const G4ThreeVector& pos) { fExitPosition = pos; }
 
@@ -46,4 +51,22 @@ private:
 
 };
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+extern G4ThreadLocal G4Allocator<UserTrackInformation>* UserTrackInformationAllocator;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void* UserTrackInformation::operator new(size_t)
+{
+    if(!UserTrackInformationAllocator)
+    UserTrackInformationAllocator = new G4Allocator<UserTrackInformation>;
+    return (void *) UserTrackInformationAllocator->MallocSingle();
+}
+
+inline void UserTrackInformation::operator delete(void *aTrackInformation)
+{
+    UserTrackInformationAllocator->FreeSingle((UserTrackInformation*) aTrackInformation);
+}
+
 #endif
@@ -10,6 +10,9 @@
 #include "DetectorConstruction.hh"
 #include "SteppingAction.hh"
 
+#include "G4RunManager.hh"
+#include "G4Version.hh"
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 ActionInitialization::ActionInitialization(DetectorConstruction* detConstruction)
@@ -27,6 +30,15 @@ ActionInitialization::~ActionInitialization()
 void ActionInitialization::BuildForMaster() const
 {
     SetUserAction(new RunAction());
+
+    #if G4VERSION_NUMBER >= 1120
+    // The master of the sub-event run manager runs the event loop itself: it
+    // tracks the tracks which are not sent to sub-events, classifies the
+    // photons and merges the hits of the sub-events.
+    if (G4RunManager::GetRunManager()->GetRunManagerType() == G4RunManager::subEventMasterRM) {
+        BuildEventActions();
+    }
+    #endif
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -34,8 +46,15 @@ void ActionInitialization::BuildForMaster() const
 void ActionInitialization::Build() const
 {
     //Here set specify user actions!
-    SetUserAction(new PrimaryGeneratorAction());
     SetUserAction(new RunAction());
+    BuildEventActions();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ActionInitialization::BuildEventActions() const
+{
+    SetUserAction(new PrimaryGeneratorAction());
     EventAction *evtAction = new EventAction();
     SetUserAction(evtAction);
     SetUserAction(new SteppingAction(fDetConstruction, evtAction));
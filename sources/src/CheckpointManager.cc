@@ -0,0 +1,298 @@
+#include "CheckpointManager.hh"
+#include "CheckpointMessenger.hh"
+#include "PersistencyManager.hh"
+#include "SeedManager.hh"
+#include "D2TBRun.hh"
+
+#include "G4RunManager.hh"
+#include "G4UIcommand.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    // The keys that every checkpoint file has, and the ones it has with an
+    // output
+    const char* kRequiredKeys[] = { "interval", "totalEvents", "firstEvent", "firstRun", "doneEvents",
+        "nextRun", "masterSeed", "events", "detectedPhotons", "scintPhotons", "absorbed",
+        "boundaryAbsorbed", "detectedMean", "detectedM2" };
+    const char* kOutputKeys[] = { "fileIndex", "reduced", "maxEventsPerFile", "maxFileSize" };
+
+    // Parse the value of a key, which must be a number as a whole; the
+    // exception thrown names the key
+    G4long ToLong(const std::map<G4String, G4String>& values, const G4String& key)
+    {
+        const G4String& value = values.at(key);
+        try {
+            std::size_t end = 0;
+            G4long result = std::stol(value, &end);
+            if (end == value.size()) return result;
+        }
+        catch (const std::exception&) {}
+        throw std::invalid_argument(key + "=" + value);
+    }
+
+    G4int ToInt(const std::map<G4String, G4String>& values, const G4String& key)
+    {
+        G4long result = ToLong(values, key);
+        if (result < std::numeric_limits<G4int>::min() || result > std::numeric_limits<G4int>::max()) {
+            throw std::invalid_argument(key + "=" + values.at(key));
+        }
+        return G4int(result);
+    }
+
+    G4double ToDouble(const std::map<G4String, G4String>& values, const G4String& key)
+    {
+        const G4String& value = values.at(key);
+        try {
+            std::size_t end = 0;
+            G4double result = std::stod(value, &end);
+            if (end == value.size()) return result;
+        }
+        catch (const std::exception&) {}
+        throw std::invalid_argument(key + "=" + value);
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CheckpointManager::CheckpointManager(PersistencyManager* persistencyManager)
+: fPersistencyManager(persistencyManager),
+fMessenger(nullptr),
+fInterval(0),
+fFilename("d2tb.checkpoint"),
+fTotalEvents(0),
+fFirstEvent(0),
+fFirstRun(0)
+{
+    fMessenger = new CheckpointMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CheckpointManager::~CheckpointManager()
+{
+    delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CheckpointManager::BeamOn(G4int nEvents)
+{
+    fTotalEvents = nEvents;
+    fFirstEvent = SeedManager::GetFirstEvent();
+    fFirstRun = -1;
+    fTotals = TG4RunSummary();
+
+    RunBlocks(0);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CheckpointManager::RunBlocks(G4int done)
+{
+    G4RunManager* runManager = G4RunManager::GetRunManager();
+
+    if (fInterval <= 0) {
+        runManager->BeamOn(fTotalEvents - done);
+        return;
+    }
+
+    if (fPersistencyManager) fPersistencyManager->SetCheckpointing(true);
+
+    while (done < fTotalEvents) {
+        G4int n = std::min(fInterval, fTotalEvents - done);
+        SeedManager::SetFirstEvent(fFirstEvent + done);
+        runManager->BeamOn(n);
+
+        const D2TBRun* run = dynamic_cast<const D2TBRun*>(runManager->GetCurrentRun());
+        if (!run) break;
+        if (fFirstRun < 0) fFirstRun = run->GetRunID();
+
+        TG4RunSummary block;
+        run->FillSummary(block);
+        fTotals.Merge(block);
+        done += run->GetNumberOfEvent();
+
+        if (fPersistencyManager) fPersistencyManager->Checkpoint();
+        Write(done, run->GetRunID()+1);
+    }
+
+    SeedManager::SetFirstEvent(fFirstEvent);
+
+    // The job is one run in the summaries, with the id of its first block
+    if (done >= fTotalEvents) {
+        fTotals.RunId = fFirstRun;
+        if (fPersistencyManager) fPersistencyManager->StoreSummary(fTotals);
+    }
+    if (fPersistencyManager) fPersistencyManager->SetCheckpointing(false);
+
+    G4cout << "CheckpointManager -- " << fTotals.Events << " events done, detected photons per event "
+    << fTotals.DetectedMean << " +- " << fTotals.GetDetectedSigma() << G4endl;
+
+    // The job is complete, there is nothing to resume
+    if (done >= fTotalEvents) std::remove(fFilename.c_str());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CheckpointManager::Write(G4int done, G4int nextRun)
+{
+    G4String temporary = fFilename + ".tmp";
+    {
+        std::ofstream out(temporary.c_str());
+        if (!out) {
+            G4cout << "CheckpointManager::Write -- Cannot write " << temporary << G4endl;
+            return false;
+        }
+
+        out << std::setprecision(17);
+        out << "version=1" << "\n";
+        out << "interval=" << fInterval << "\n";
+        out << "totalEvents=" << fTotalEvents << "\n";
+        out << "firstEvent=" << fFirstEvent << "\n";
+        out << "firstRun=" << fFirstRun << "\n";
+        out << "doneEvents=" << done << "\n";
+        out << "nextRun=" << nextRun << "\n";
+        out << "masterSeed=" << SeedManager::GetMasterSeed() << "\n";
+        if (fPersistencyManager) {
+            out << "output=" << fPersistencyManager->GetFilename() << "\n";
+            out << "fileIndex=" << fPersistencyManager->GetFileIndex() << "\n";
+            out << "eventsInFile=" << fPersistencyManager->GetEventsInFile() << "\n";
+            out << "reduced=" << fPersistencyManager->GetReducedOutput() << "\n";
+            out << "maxEventsPerFile=" << fPersistencyManager->GetMaxEventsPerFile() << "\n";
+            out << "maxFileSize=" << fPersistencyManager->GetMaxFileSize() << "\n";
+        }
+        out << "events=" << fTotals.Events << "\n";
+        out << "detectedPhotons=" << fTotals.DetectedPhotons << "\n";
+        out << "scintPhotons=" << fTotals.ScintPhotons << "\n";
+        out << "absorbed=" << fTotals.Absorbed << "\n";
+        out << "boundaryAbsorbed=" << fTotals.BoundaryAbsorbed << "\n";
+        out << "detectedMean=" << fTotals.DetectedMean << "\n";
+        out << "detectedM2=" << fTotals.DetectedM2 << "\n";
+
+        out.flush();
+        if (!out) {
+            G4cout << "CheckpointManager::Write -- Cannot write " << temporary << G4endl;
+            return false;
+        }
+    }
+
+    if (std::rename(temporary.c_str(), fFilename.c_str()) != 0) {
+        G4cout << "CheckpointManager::Write -- Cannot rename " << temporary << G4endl;
+        return false;
+    }
+
+    G4cout << "CheckpointManager -- Checkpoint after " << done << " of "
+    << fTotalEvents << " events in " << fFilename << G4endl;
+
+    return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CheckpointManager::Read(const G4String& filename, std::map<G4String, G4String>& values)
+{
+    std::ifstream in(filename.c_str());
+    if (!in) return false;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        std::size_t equal = line.find('=');
+        if (equal == std::string::npos) continue;
+        values[line.substr(0, equal)] = line.substr(equal+1);
+    }
+
+    return values.count("version") && values.count("doneEvents");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CheckpointManager::Resume(const G4String& filename)
+{
+    std::map<G4String, G4String> values;
+    if (!Read(filename, values)) {
+        G4ExceptionDescription msg;
+        msg << "Cannot read the checkpoint file " << filename;
+        G4Exception("CheckpointManager::Resume()", "Checkpoint0001", FatalException, msg);
+        return false;
+    }
+
+    // A truncated or edited file must not resume a job with wrong counters
+    std::vector<G4String> keys(std::begin(kRequiredKeys), std::end(kRequiredKeys));
+    if (values.count("output")) keys.insert(keys.end(), std::begin(kOutputKeys), std::end(kOutputKeys));
+    for (const G4String& key : keys) {
+        if (!values.count(key)) {
+            G4ExceptionDescription msg;
+            msg << "The checkpoint file " << filename << " has no " << key;
+            G4Exception("CheckpointManager::Resume()", "Checkpoint0002", FatalException, msg);
+            return false;
+        }
+    }
+
+    G4int done = 0;
+    G4long masterSeed = 0;
+    G4int nextRun = 0;
+    try {
+        fInterval = ToInt(values, "interval");
+        fTotalEvents = ToInt(values, "totalEvents");
+        fFirstEvent = ToInt(values, "firstEvent");
+        fFirstRun = ToInt(values, "firstRun");
+        done = ToInt(values, "doneEvents");
+        nextRun = ToInt(values, "nextRun");
+        masterSeed = ToLong(values, "masterSeed");
+
+        fTotals = TG4RunSummary();
+        fTotals.Events = ToLong(values, "events");
+        fTotals.DetectedPhotons = ToLong(values, "detectedPhotons");
+        fTotals.ScintPhotons = ToLong(values, "scintPhotons");
+        fTotals.Absorbed = ToLong(values, "absorbed");
+        fTotals.BoundaryAbsorbed = ToLong(values, "boundaryAbsorbed");
+        fTotals.DetectedMean = ToDouble(values, "detectedMean");
+        fTotals.DetectedM2 = ToDouble(values, "detectedM2");
+
+        // Only checked here, the output is reopened below
+        if (values.count("output")) {
+            ToInt(values, "fileIndex");
+            ToInt(values, "maxEventsPerFile");
+            ToDouble(values, "maxFileSize");
+            if (values.count("eventsInFile")) ToInt(values, "eventsInFile");
+        }
+    }
+    catch (const std::exception& e) {
+        G4ExceptionDescription msg;
+        msg << "The checkpoint file " << filename << " has a bad value: " << e.what();
+        G4Exception("CheckpointManager::Resume()", "Checkpoint0003", FatalException, msg);
+        return false;
+    }
+
+    fFilename = filename;
+    SeedManager::SetMasterSeed(masterSeed);
+    G4RunManager::GetRunManager()->SetRunIDCounter(nextRun);
+
+    if (fPersistencyManager && values.count("output")) {
+        fPersistencyManager->SetReducedOutput(G4UIcommand::ConvertToBool(values["reduced"]));
+        fPersistencyManager->SetMaxEventsPerFile(ToInt(values, "maxEventsPerFile"));
+        fPersistencyManager->SetMaxFileSize(ToDouble(values, "maxFileSize"));
+        fPersistencyManager->SetCheckpointing(true);
+        // The events written after the checkpoint (kept in a file closed by
+        // a rotation) are dropped, they are run again
+        G4int eventsInFile = -1;
+        if (values.count("eventsInFile")) eventsInFile = ToInt(values, "eventsInFile");
+        fPersistencyManager->Reopen(values["output"], ToInt(values, "fileIndex"), eventsInFile);
+    }
+
+    G4cout << "CheckpointManager -- Resume after " << done << " of " << fTotalEvents
+    << " events from " << filename << G4endl;
+
+    RunBlocks(done);
+
+    return true;
+}
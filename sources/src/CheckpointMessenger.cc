@@ -0,0 +1,78 @@
+#include "CheckpointMessenger.hh"
+#include "CheckpointManager.hh"
+
+#include <G4UIcommand.hh>
+#include <G4UIparameter.hh>
+#include <G4UIcmdWithAString.hh>
+#include <G4UIcmdWithAnInteger.hh>
+
+#include <sstream>
+
+CheckpointMessenger::CheckpointMessenger(CheckpointManager* checkpointMgr)
+: fCheckpointManager(checkpointMgr)
+{
+    // The /d2tb/run/ directory is created by the SeedMessenger
+
+    fCheckpointCMD = new G4UIcommand("/d2tb/run/checkpoint", this);
+    fCheckpointCMD->SetGuidance("Save a checkpoint every n events of /d2tb/run/beamOn.");
+    fCheckpointCMD->SetGuidance("Set n to zero to run without checkpoints.");
+    G4UIparameter* eventsPrm = new G4UIparameter("events", 'i', false);
+    eventsPrm->SetParameterRange("events>=0");
+    fCheckpointCMD->SetParameter(eventsPrm);
+    G4UIparameter* filePrm = new G4UIparameter("filename", 's', true);
+    filePrm->SetDefaultValue("d2tb.checkpoint");
+    fCheckpointCMD->SetParameter(filePrm);
+    fCheckpointCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fCheckpointCMD->SetToBeBroadcasted(false);
+
+    fBeamOnCMD = new G4UIcmdWithAnInteger("/d2tb/run/beamOn", this);
+    fBeamOnCMD->SetGuidance("Run events, saving a checkpoint as set by /d2tb/run/checkpoint.");
+    fBeamOnCMD->SetParameterName("events", false);
+    fBeamOnCMD->SetRange("events>=0");
+    fBeamOnCMD->AvailableForStates(G4State_Idle);
+    fBeamOnCMD->SetToBeBroadcasted(false);
+
+    fResumeCMD = new G4UIcmdWithAString("/d2tb/run/resume", this);
+    fResumeCMD->SetGuidance("Continue the job saved in a checkpoint file.");
+    fResumeCMD->SetGuidance("The geometry and the gun must be set as in the original job.");
+    fResumeCMD->SetParameterName("filename", false);
+    fResumeCMD->AvailableForStates(G4State_Idle);
+    fResumeCMD->SetToBeBroadcasted(false);
+}
+
+CheckpointMessenger::~CheckpointMessenger()
+{
+    delete fCheckpointCMD;
+    delete fBeamOnCMD;
+    delete fResumeCMD;
+}
+
+void CheckpointMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fCheckpointCMD) {
+        std::istringstream is(newValue);
+        G4int events;
+        G4String filename;
+        is >> events >> filename;
+        fCheckpointManager->SetInterval(events);
+        fCheckpointManager->SetFilename(filename);
+    }
+    else if (command == fBeamOnCMD) {
+        fCheckpointManager->BeamOn(fBeamOnCMD->GetNewIntValue(newValue));
+    }
+    else if (command == fResumeCMD) {
+        fCheckpointManager->Resume(newValue);
+    }
+}
+
+G4String CheckpointMessenger::GetCurrentValue(G4UIcommand * command)
+{
+    G4String currentValue;
+
+    if (command == fCheckpointCMD) {
+        currentValue = G4UIcommand::ConvertToString(fCheckpointManager->GetInterval())
+        + " " + fCheckpointManager->GetFilename();
+    }
+
+    return currentValue;
+}
@@ -0,0 +1,108 @@
+#include "CrystalShowerSD.hh"
+#include "GenstepManager.hh"
+#include "Genstep.hh"
+
+#include "G4GFlashSpot.hh"
+#include "GFlashEnergySpot.hh"
+#include "G4FastTrack.hh"
+#include "G4Track.hh"
+#include "G4DynamicParticle.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4Electron.hh"
+#include "G4Material.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4ProcessTable.hh"
+#include "G4EventManager.hh"
+#include "G4TrackVector.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CrystalShowerSD::CrystalShowerSD(G4String name, G4int verbose)
+: G4VSensitiveDetector(name),
+G4VGFlashSensitiveDetector(),
+fScintillation(nullptr),
+fVerbose(verbose)
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CrystalShowerSD::~CrystalShowerSD() { }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CrystalShowerSD::ProcessHits(G4Step* , G4TouchableHistory* )
+{
+    return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CrystalShowerSD::ProcessHits(G4GFlashSpot* aSpot, G4TouchableHistory* )
+{
+    G4double edep = aSpot->GetEnergySpot()->GetEnergy();
+    if (edep <= 0.) return false;
+
+    G4Material* material = aSpot->GetTouchableHandle()->GetVolume()->GetLogicalVolume()->GetMaterial();
+    const ScintillationSampler::Emission* emission = fSampler.GetEmission(material);
+    if (!emission) return false;
+
+    // Looked up once the processes are built
+    if (!fScintillation) {
+        fScintillation = G4ProcessTable::GetProcessTable()->FindProcess("Scintillation", G4Electron::Electron());
+    }
+
+    // Number of photons, with the fluctuations of G4Scintillation
+    G4int nPhotons = fSampler.SampleNumberOfPhotons(*emission, edep);
+    if (nPhotons <= 0) return true;
+
+    // The shower is instantaneous, the photons start from the spot at the
+    // time of the particle which was parameterised
+    const G4Track* parent = aSpot->GetOriginatorTrack()->GetPrimaryTrack();
+    G4ThreeVector position = aSpot->GetEnergySpot()->GetPosition();
+
+    if (GenstepManager::IsRecording()) {
+        Genstep genstep;
+        genstep.fStart = genstep.fEnd = position;
+        genstep.fStartTime = genstep.fEndTime = parent->GetGlobalTime();
+        genstep.fEnergyDeposit = edep;
+        genstep.fNumPhotons = nPhotons;
+        genstep.fTrackId = parent->GetTrackID();
+        genstep.fPDGCode = parent->GetDefinition()->GetPDGEncoding();
+        genstep.fMaterial = material;
+        GenstepManager::Record(genstep);
+        return true;
+    }
+
+    G4TrackVector photons;
+    photons.reserve(nPhotons);
+    for (G4int i = 0; i < nPhotons; i++) {
+        // Isotropic direction and random linear polarization
+        G4ThreeVector direction;
+        G4ThreeVector polarization;
+        ScintillationSampler::SampleDirection(direction, polarization);
+
+        G4DynamicParticle* photon = new G4DynamicParticle(G4OpticalPhoton::OpticalPhoton(), direction, fSampler.SampleEnergy(*emission));
+        photon->SetPolarization(polarization.x(), polarization.y(), polarization.z());
+
+        G4double time = parent->GetGlobalTime() + fSampler.SampleDelay(*emission);
+
+        G4Track* track = new G4Track(photon, time, position);
+        track->SetParentID(parent->GetTrackID());
+        track->SetCreatorProcess(fScintillation);
+        track->SetTouchableHandle(aSpot->GetTouchableHandle());
+        photons.push_back(track);
+    }
+
+    // The event manager numbers the tracks and classifies them
+    G4EventManager::GetEventManager()->StackTracks(&photons);
+
+    if (fVerbose > 1) {
+        G4cout << "CrystalShowerSD::ProcessHits() : " << nPhotons << " photons from a spot of "
+        << edep/MeV << " MeV" << G4endl;
+    }
+
+    return true;
+}
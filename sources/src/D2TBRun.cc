@@ -1,5 +1,20 @@
 #include "D2TBRun.hh"
+#include "TG4RunSummary.hh"
+#include "G4RunManager.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4Version.hh"
+
+#include <cmath>
+
+namespace {
+    // Binning of the arrival time distributions
+    const G4int kTimeBins = 500;
+    const G4double kTimeMax = 250*ns;
+
+    // Range of the flat index of the accumulators of the SiPMs
+    const G4int kMaxCrystal = 64;
+    const G4int kMaxSiPM = 256;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -9,6 +24,9 @@ D2TBRun::D2TBRun() : G4Run()
     fPhotonCount_Scint       = 0;
     fAbsorptionCount         = 0;
     fBoundaryAbsorptionCount = 0;
+    fDetectedEvents          = 0;
+    fDetectedMean            = 0.;
+    fDetectedM2              = 0.;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -18,6 +36,93 @@ D2TBRun::~D2TBRun()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+G4int D2TBRun::GetTimeBins()
+{
+    return kTimeBins;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double D2TBRun::GetTimeMax()
+{
+    return kTimeMax;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void D2TBRun::AddDetectedPhoton(G4int crystalNo, G4int SiPMNo, G4double time)
+{
+    // The accumulators of a SiPM are only looked up in the maps for its
+    // first photon, then through a flat index by crystal and SiPM number
+    // (the map nodes do not move).
+    SiPMAccumulators* accumulators = nullptr;
+    SiPMAccumulators lookup = { nullptr, nullptr };
+    if (crystalNo >= 0 && crystalNo < kMaxCrystal && SiPMNo >= 0 && SiPMNo < kMaxSiPM) {
+        if (fSiPMIndex.empty()) fSiPMIndex.resize(kMaxCrystal*kMaxSiPM, lookup);
+        accumulators = &fSiPMIndex[crystalNo*kMaxSiPM + SiPMNo];
+    }
+    else {
+        accumulators = &lookup;
+    }
+
+    if (!accumulators->bins) {
+        accumulators->yield = &fCrystalYield[crystalNo];
+        accumulators->bins = &fArrivalTimes[SiPMKey(crystalNo, SiPMNo)];
+        if (accumulators->bins->empty()) accumulators->bins->resize(kTimeBins+2, 0.);
+    }
+
+    *accumulators->yield += 1;
+
+    G4int bin = 0;
+    if (time >= kTimeMax) bin = kTimeBins+1;
+    else if (time >= 0) bin = 1 + G4int(time/kTimeMax*kTimeBins);
+    (*accumulators->bins)[bin] += 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void D2TBRun::AddEventDetectedPhotons(G4int count)
+{
+    ++fDetectedEvents;
+    G4double delta = count - fDetectedMean;
+    fDetectedMean += delta/fDetectedEvents;
+    fDetectedM2 += delta*(count - fDetectedMean);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double D2TBRun::GetDetectedVariance() const
+{
+    if (fDetectedEvents < 2) return 0.;
+    return fDetectedM2/(fDetectedEvents-1);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void D2TBRun::FillSummary(TG4RunSummary& summary) const
+{
+    summary.RunId = GetRunID();
+    summary.Events = fDetectedEvents;
+    summary.DetectedPhotons = fHitCount;
+    summary.ScintPhotons = fPhotonCount_Scint;
+    summary.Absorbed = fAbsorptionCount;
+    summary.BoundaryAbsorbed = fBoundaryAbsorptionCount;
+    summary.DetectedMean = fDetectedMean;
+    summary.DetectedM2 = fDetectedM2;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void D2TBRun::RecordEvent(const G4Event* event)
+{
+#if G4VERSION_NUMBER >= 1120
+    if (G4RunManager::GetRunManager()->GetRunManagerType() == G4RunManager::subEventWorkerRM) return;
+#endif
+    G4Run::RecordEvent(event);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void D2TBRun::Merge(const G4Run* run)
 {
     const D2TBRun* localRun = static_cast<const D2TBRun*>(run);
@@ -27,6 +132,26 @@ void D2TBRun::Merge(const G4Run* run)
     fAbsorptionCount          += localRun->fAbsorptionCount;
     fBoundaryAbsorptionCount  += localRun->fBoundaryAbsorptionCount;
 
+    // Combine the running means and variances of the threads (Chan et al.)
+    if (localRun->fDetectedEvents > 0) {
+        G4double n1 = fDetectedEvents;
+        G4double n2 = localRun->fDetectedEvents;
+        G4double delta = localRun->fDetectedMean - fDetectedMean;
+        fDetectedMean += delta*n2/(n1+n2);
+        fDetectedM2 += localRun->fDetectedM2 + delta*delta*n1*n2/(n1+n2);
+        fDetectedEvents += localRun->fDetectedEvents;
+    }
+
+    for (const auto& crystal : localRun->fCrystalYield) {
+        fCrystalYield[crystal.first] += crystal.second;
+    }
+
+    for (const auto& sipm : localRun->fArrivalTimes) {
+        std::vector<G4double>& bins = fArrivalTimes[sipm.first];
+        if (bins.empty()) bins.resize(kTimeBins+2, 0.);
+        for (std::size_t i = 0; i < bins.size(); ++i) bins[i] += sipm.second[i];
+    }
+
     G4Run::Merge(run);
 }
 
@@ -52,7 +177,13 @@ void D2TBRun::EndOfRun()
 
     G4double bdry = G4double(fBoundaryAbsorptionCount)/n_evt;
     G4cout << "Number of photons absorbed at boundary per event:\t " << bdry << G4endl;
-    
+
+    G4double sigma = std::sqrt(GetDetectedVariance());
+    G4cout << "Detected photons per event (mean, sigma):\t " << fDetectedMean << " " << sigma << G4endl;
+    if (fDetectedMean > 0) {
+        G4cout << "Resolution (sigma/mean):\t " << sigma/fDetectedMean << G4endl;
+    }
+
     G4cout << G4endl;
     G4cout.precision(prec);
 }
@@ -21,6 +21,7 @@
 #include "G4LogicalBorderSurface.hh"
 
 #include "G4SDManager.hh"
+#include "G4Region.hh"
 
 #include "G4VisAttributes.hh"
 #include "G4Colour.hh"
@@ -30,9 +31,24 @@
 #include "G4UnitsTable.hh"
 
 #include "PhotonDetSD.hh"
+#include "CrystalShowerSD.hh"
+
+#include "GFlashShowerModel.hh"
+#include "GFlashHomoShowerParameterisation.hh"
+#include "GFlashParticleBounds.hh"
+#include "GFlashHitMaker.hh"
+#include "G4Electron.hh"
+#include "G4Positron.hh"
 
 #include "G4UserLimits.hh"
 
+namespace {
+    // Layout of the SiPMs on the back face of each crystal
+    const G4int kNSiPMPerRow = 5;
+    const G4int kNSiPMRow = 5;
+    const G4double kSiPMSpacing = 0.5*cm;
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 DetectorConstruction::DetectorConstruction(bool validateGeo)
@@ -52,12 +68,32 @@ fSiPM_PDE(1.0),
 fDetectorMessenger(nullptr),
 fVerboseLevel(1),
 fSDVerboseLevel(0),
+fModified(0),
 fDefaultMaterial(nullptr),
+fCrystalMaterial(nullptr),
+fSiPMMaterial(nullptr),
+fPhotonDetSurfaceProperty(nullptr),
 fWorldLogical(nullptr),
 fCrystalLogical(nullptr),
+fSiPMLogical(nullptr),
 fWorldPhysical(nullptr),
-fCrystalPhysical(nullptr)
+fCrystalPhysical(nullptr),
+fCrystalBox(nullptr),
+fHoleBox(nullptr),
+fSiPMBox(nullptr),
+fPhotonDetBox(nullptr),
+fPhotonDetPhysical(nullptr),
+fCrystalRegion(nullptr),
+fSiPMRegion(nullptr),
+fWorldLimits(nullptr),
+fWorldKillEnergy(0),
+fKillPhotonsInWorld(false),
+fShowerParameterisation(false),
+fShowerThreshold(100*MeV)
 {
+    //No limit until a kill energy is set
+    fWorldLimits = new G4UserLimits();
+
     //Compute Params
     fDetectorMessenger = new DetectorMessenger(this);
 }
@@ -67,6 +103,7 @@ fCrystalPhysical(nullptr)
 DetectorConstruction::~DetectorConstruction()
 {
     delete fDetectorMessenger;
+    delete fWorldLimits;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -75,6 +112,10 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
 {
     //Reset the geometry
     if (fWorldPhysical) {
+        //The regions are kept, without the volumes about to be deleted
+        fCrystalRegion->RemoveRootLogicalVolume(fCrystalLogical, false);
+        fSiPMRegion->RemoveRootLogicalVolume(fSiPMLogical, false);
+
         G4GeometryManager::GetInstance()->OpenGeometry();
         G4PhysicalVolumeStore::GetInstance()->Clean();
         G4LogicalVolumeStore::GetInstance()->Clean();
@@ -85,9 +126,11 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
 
     //Update Geometry parameters
     UpdateGeometryParameters();
+    fModified = 0;
 
-    // Define materials
-    DefineMaterials();
+    // Define materials, once: the materials are not cleaned with the
+    // geometry and new ones would rebuild the physics tables.
+    if (!fCrystalMaterial) DefineMaterials();
 
     // Define volumes
     return ConstructDetector();
@@ -218,9 +261,11 @@ G4VPhysicalVolume* DetectorConstruction::ConstructDetector()
     fWorldLogical = new G4LogicalVolume(worldBox, fDefaultMaterial, "WorldBoxLV");
     // Placement of the World Logical Volume
     fWorldPhysical = new G4PVPlacement(0, G4ThreeVector(), fWorldLogical, "WorldBox", 0, false, 0, fCheckOverlaps);
+    fWorldLogical->SetUserLimits(fWorldLimits);
 
     //Build the crystals and SiPMs
     BuildCrystalandSiPM();
+    ConstructRegions();
 
     //World is invisible
     fWorldLogical->SetVisAttributes (G4VisAttributes::GetInvisible());
@@ -235,6 +280,20 @@ G4VPhysicalVolume* DetectorConstruction::ConstructDetector()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void DetectorConstruction::ConstructRegions()
+{
+    //The crystals with their holes, and the SiPMs with their photocathode,
+    //each get their production cuts (see /d2tb/phys/regionCut).  The world
+    //is the default region.
+    if (!fCrystalRegion) fCrystalRegion = new G4Region("CrystalRegion");
+    fCrystalRegion->AddRootLogicalVolume(fCrystalLogical);
+
+    if (!fSiPMRegion) fSiPMRegion = new G4Region("SiPMRegion");
+    fSiPMRegion->AddRootLogicalVolume(fSiPMLogical);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void DetectorConstruction::ConstructSDandField()
 {
     if (!fSD.Get()) {
@@ -246,14 +305,51 @@ void DetectorConstruction::ConstructSDandField()
         G4cout << "DetectorConstruction::ConstructSDandField() : Constructed sensitive detector " << SDName << G4endl;
     }
     SetSensitiveDetector("PhotonDetLV", fSD.Get(), true);
+
+    if (fShowerParameterisation) ConstructShowerModel();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::ConstructShowerModel()
+{
+    //The model stays attached to the crystal region when the geometry is
+    //rebuilt, only the sensitive detector goes to the new crystal volume
+    if (!fShowerModel.Get()) {
+        auto model = new GFlashShowerModel("CrystalShowerModel", fCrystalRegion);
+
+        //They live as long as the thread, like the model
+        auto parameterisation = new GFlashHomoShowerParameterisation(fCrystalMaterial);
+        model->SetParameterisation(*parameterisation);
+
+        auto bounds = new GFlashParticleBounds();
+        bounds->SetMinEneToParametrise(*G4Electron::ElectronDefinition(), fShowerThreshold);
+        bounds->SetMinEneToParametrise(*G4Positron::PositronDefinition(), fShowerThreshold);
+        model->SetParticleBounds(*bounds);
+
+        auto hitMaker = new GFlashHitMaker();
+        model->SetHitMaker(*hitMaker);
+
+        model->SetFlagParamOn(1);
+        fShowerModel.Put(model);
+
+        G4String SDName = "d2tb/CrystalShower";
+        CrystalShowerSD* SD = new CrystalShowerSD(SDName, GetSDVerboseLevel());
+        G4SDManager::GetSDMpointer()->AddNewDetector(SD);
+        fShowerSD.Put(SD);
+
+        G4cout << "DetectorConstruction::ConstructShowerModel() : Parameterised showers above "
+        << G4BestUnit(fShowerThreshold, "Energy") << " in " << fCrystalRegion->GetName() << G4endl;
+    }
+    SetSensitiveDetector("CrystalLV", fShowerSD.Get(), true);
 }
 
 void DetectorConstruction::BuildCrystalandSiPM()
 {
     const G4int nbins = 1;
     //Crystal
-    auto Crystal = new G4Box("Crystal", fCrystalSizeXY/2, fCrystalSizeXY/2, fCrystalDepth/2);
-    fCrystalLogical = new G4LogicalVolume(Crystal, fCrystalMaterial, "CrystalLV");
+    fCrystalBox = new G4Box("Crystal", fCrystalSizeXY/2, fCrystalSizeXY/2, fCrystalDepth/2);
+    fCrystalLogical = new G4LogicalVolume(fCrystalBox, fCrystalMaterial, "CrystalLV");
 
     auto CrystalVisAtt = new G4VisAttributes(G4Colour(0.0,1.0,1.0));
     CrystalVisAtt->SetVisibility(true);
@@ -261,21 +357,23 @@ void DetectorConstruction::BuildCrystalandSiPM()
 
     //Hole inside the crystal to house the SiPM
     G4double fHoleDepth = 2*fSiPMDepth;
-    auto Hole = new G4Box("Hole", fSiPMSizeXY/2, fSiPMSizeXY/2, fHoleDepth);
-    auto logicHole = new G4LogicalVolume(Hole, fDefaultMaterial, "HoleLV");
+    fHoleBox = new G4Box("Hole", fSiPMSizeXY/2, fSiPMSizeXY/2, fHoleDepth);
+    auto logicHole = new G4LogicalVolume(fHoleBox, fDefaultMaterial, "HoleLV");
     //SiPM
-    auto SiPM = new G4Box("SiPM", fSiPMSizeXY/2, fSiPMSizeXY/2, fSiPMDepth);
-    auto logicSiPM = new G4LogicalVolume(SiPM, fDefaultMaterial, "SiPMLV");
+    fSiPMBox = new G4Box("SiPM", fSiPMSizeXY/2, fSiPMSizeXY/2, fSiPMDepth);
+    auto logicSiPM = new G4LogicalVolume(fSiPMBox, fDefaultMaterial, "SiPMLV");
+    fSiPMLogical = logicSiPM;
     //Photocathode inside the SiPM
-    auto PhotonDet = new G4Box("PhotonDet", fSiPMSizeXY/2, fSiPMSizeXY/2, fSiPMDepth/2);
-    auto logicPhotonDet = new G4LogicalVolume(PhotonDet, fSiPMMaterial, "PhotonDetLV");
-    new G4PVPlacement(0, G4ThreeVector(0., 0., -fSiPMDepth/2.), logicPhotonDet, "PhotonDet", logicSiPM, false, 0, fCheckOverlaps);
+    fPhotonDetBox = new G4Box("PhotonDet", fSiPMSizeXY/2, fSiPMSizeXY/2, fSiPMDepth/2);
+    auto logicPhotonDet = new G4LogicalVolume(fPhotonDetBox, fSiPMMaterial, "PhotonDetLV");
+    fPhotonDetPhysical = new G4PVPlacement(0, G4ThreeVector(0., 0., -fSiPMDepth/2.), logicPhotonDet, "PhotonDet", logicSiPM, false, 0, fCheckOverlaps);
 
     //----------------------------------------------------------------------
     // PhotonDet Surface Properties
     G4OpticalSurface* photonDetSurface = new G4OpticalSurface("PhotonDetSurface", glisur, ground, dielectric_metal, 1.0);
 
     G4MaterialPropertiesTable* photonDetSurfaceProperty = new G4MaterialPropertiesTable();
+    fPhotonDetSurfaceProperty = photonDetSurfaceProperty;
     G4double p_mppc[nbins] = { 2.8 *eV };
     G4double refl_mppc[nbins] = { 0 };
     G4double effi_mppc[nbins] = { fSiPM_PDE };
@@ -293,84 +391,36 @@ void DetectorConstruction::BuildCrystalandSiPM()
 
     //---------------------- Placement of the SiPMs ------------------------------------------------
 
-    G4double spacing = 0.5*cm;
-
-    G4int fNSiPMPerRow = 5;
-    G4int fNSiPMRow = 5;
-    std::vector< std::vector<G4VPhysicalVolume*> > physHole;
-    physHole.reserve(fNSiPMRow);
-    std::vector< std::vector<G4VPhysicalVolume*> > physSiPM;
-    physSiPM.reserve(fNSiPMRow);
-    std::vector<G4VPhysicalVolume*> vecphysHole;
-    std::vector<G4VPhysicalVolume*> vecphysSiPM;
+    fHolePhysicals.clear();
+    fHolePhysicals.reserve(kNSiPMRow*kNSiPMPerRow);
+    fSiPMPhysicals.clear();
+    fSiPMPhysicals.reserve(kNSiPMRow*kNSiPMPerRow);
 
-    for(int irow = 0; irow < fNSiPMRow; irow++)
+    for(int irow = 0; irow < kNSiPMRow; irow++)
     {
-        G4double fOffsetX = 0.;
-        G4double fOffsetY = 0.;
-
-        fOffsetY = -fCrystalSizeXY/2+spacing + irow*spacing;
-
-        vecphysHole.clear();
-        vecphysHole.reserve(fNSiPMPerRow);
-
-        vecphysSiPM.clear();
-        vecphysSiPM.reserve(fNSiPMPerRow);
-
-        for(int iSiPM = 0; iSiPM < fNSiPMPerRow; iSiPM++)
+        for(int iSiPM = 0; iSiPM < kNSiPMPerRow; iSiPM++)
         {
             G4String SiPMname = "SiPM";
-            // SiPMname += G4UIcommand::ConvertToString(iSiPM+1);
-            // SiPMname += "_Row";
-            // SiPMname += G4UIcommand::ConvertToString(irow+1);
-
             G4String Holename = "Hole";
-            // Holename += G4UIcommand::ConvertToString(iSiPM+1);
-            // Holename += "_Row";
-            // Holename += G4UIcommand::ConvertToString(irow+1);
-
-            fOffsetX = -fCrystalSizeXY/2+spacing + iSiPM*spacing;
 
             //Hole placement inside the crystal
-            // physHole[irow][iSiPM] = new G4PVPlacement(0, G4ThreeVector(fOffsetX, fOffsetY, -fCrystalDepth/2+fHoleDepth), logicHole, Holename, fCrystalLogical, false, irow+10*irow, fCheckOverlaps);
-
-            vecphysHole.push_back( new G4PVPlacement(0, G4ThreeVector(fOffsetX, fOffsetY, -fCrystalDepth/2+fHoleDepth), logicHole, Holename, fCrystalLogical, false, irow+10*irow, fCheckOverlaps) );
+            fHolePhysicals.push_back( new G4PVPlacement(0, GetHolePosition(irow, iSiPM), logicHole, Holename, fCrystalLogical, false, irow+10*irow, fCheckOverlaps) );
 
             //SiPM placement inside the hole
-            // physSiPM[irow][iSiPM] = new G4PVPlacement(0, G4ThreeVector(0., 0., -fSiPMDepth), logicSiPM, SiPMname, logicHole, false, irow+10*irow, fCheckOverlaps);
-            vecphysSiPM.push_back( new G4PVPlacement(0, G4ThreeVector(0., 0., -fSiPMDepth), logicSiPM, SiPMname, logicHole, false, irow+10*irow, fCheckOverlaps) );
+            fSiPMPhysicals.push_back( new G4PVPlacement(0, G4ThreeVector(0., 0., -fSiPMDepth), logicSiPM, SiPMname, logicHole, false, irow+10*irow, fCheckOverlaps) );
         }
-
-        physHole.push_back( vecphysHole );
-        physSiPM.push_back( vecphysSiPM );
     }
 
-    std::vector<G4VPhysicalVolume*> physCrystal;
+    std::vector<G4VPhysicalVolume*>& physCrystal = fCrystalPhysicals;
+    physCrystal.clear();
     physCrystal.reserve(fNCrystal);
 
     //---------------------- Placement of the Crystals --------------------------------------------
     for(int iCrystal = 0; iCrystal < fNCrystal; iCrystal++){
         G4String name = "Crystal";
 
-        G4double fOffsetX = 0.;
-        G4double fOffsetY = 0.;
-
-        if(iCrystal < fNCrystalPerRow){
-            fOffsetX = (-fCaloSizeXY+fCrystalSizeXY)/2 + iCrystal*fCrystalSizeXY;
-            fOffsetY = (-fCaloSizeXY+fCrystalSizeXY)/2;
-        }
-        if(iCrystal >= fNCrystalPerRow && iCrystal < 2*fNCrystalPerRow){
-            fOffsetX = (-fCaloSizeXY+fCrystalSizeXY)/2 + (iCrystal-fNCrystalPerRow)*fCrystalSizeXY;
-            fOffsetY = (-fCaloSizeXY+fCrystalSizeXY)/2 + fCrystalSizeXY;
-        }
-        if(iCrystal >= 2*fNCrystalPerRow){
-            fOffsetX = (-fCaloSizeXY+fCrystalSizeXY)/2 + (iCrystal-2*fNCrystalPerRow)*fCrystalSizeXY;
-            fOffsetY = (-fCaloSizeXY+fCrystalSizeXY)/2 + 2*fCrystalSizeXY;
-        }
-
         //Place Crystal
-        // physCrystal[iCrystal] = new G4PVPlacement(0, G4ThreeVector(fOffsetX, fOffsetY, -fCrystalDepth/2), fCrystalLogical, name, fWorldLogical, false, iCrystal, fCheckOverlaps);
-        physCrystal.push_back( new G4PVPlacement(0, G4ThreeVector(fOffsetX, fOffsetY, -fCrystalDepth/2), fCrystalLogical, name, fWorldLogical, false, iCrystal, fCheckOverlaps) );
+        physCrystal.push_back( new G4PVPlacement(0, GetCrystalPosition(iCrystal), fCrystalLogical, name, fWorldLogical, false, iCrystal, fCheckOverlaps) );
     }
 
     //Border between crystals
@@ -406,6 +456,121 @@ void DetectorConstruction::BuildCrystalandSiPM()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+G4ThreeVector DetectorConstruction::GetCrystalPosition(G4int iCrystal) const
+{
+    G4int row = iCrystal/fNCrystalPerRow;
+    G4int column = iCrystal%fNCrystalPerRow;
+
+    G4double fOffsetX = (-fCaloSizeXY+fCrystalSizeXY)/2 + column*fCrystalSizeXY;
+    G4double fOffsetY = (-fCaloSizeXY+fCrystalSizeXY)/2 + row*fCrystalSizeXY;
+
+    return G4ThreeVector(fOffsetX, fOffsetY, -fCrystalDepth/2);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ThreeVector DetectorConstruction::GetHolePosition(G4int irow, G4int iSiPM) const
+{
+    G4double fHoleDepth = 2*fSiPMDepth;
+    G4double fOffsetX = -fCrystalSizeXY/2+kSiPMSpacing + iSiPM*kSiPMSpacing;
+    G4double fOffsetY = -fCrystalSizeXY/2+kSiPMSpacing + irow*kSiPMSpacing;
+
+    return G4ThreeVector(fOffsetX, fOffsetY, -fCrystalDepth/2+fHoleDepth);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::UpdateGeometry()
+{
+    if (!fModified) return;
+
+    // Not built yet, Construct() will use the new parameters
+    if (!fWorldPhysical) {
+        fModified = 0;
+        return;
+    }
+
+    // The number of crystals changes the placements and the border surfaces,
+    // the whole geometry is built again.
+    if (fModified & kLayoutModified) {
+        G4RunManager::GetRunManager()->ReinitializeGeometry();
+        return;
+    }
+
+    // The other parameters only change the size of the solids and the
+    // position of the placements, which are updated in place.
+    G4bool geometryModified = fModified & (kCrystalModified | kSiPMModified);
+    if (geometryModified) {
+        G4GeometryManager::GetInstance()->OpenGeometry(fWorldPhysical);
+        UpdateGeometryParameters();
+    }
+    if (fModified & kCrystalModified) UpdateCrystals();
+    if (geometryModified) UpdateSiPMs();
+    if (fModified & kSurfaceModified) UpdatePDE();
+
+    fModified = 0;
+
+    // The geometry is closed again (and the voxels rebuilt) at the next run
+    if (geometryModified) G4RunManager::GetRunManager()->GeometryHasBeenModified();
+
+    if(fVerboseLevel > 0)
+    PrintParameters();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::UpdateCrystals()
+{
+    fCrystalBox->SetXHalfLength(fCrystalSizeXY/2);
+    fCrystalBox->SetYHalfLength(fCrystalSizeXY/2);
+    fCrystalBox->SetZHalfLength(fCrystalDepth/2);
+
+    for (std::size_t iCrystal = 0; iCrystal < fCrystalPhysicals.size(); iCrystal++) {
+        fCrystalPhysicals[iCrystal]->SetTranslation(GetCrystalPosition(iCrystal));
+        if (fCheckOverlaps) fCrystalPhysicals[iCrystal]->CheckOverlaps();
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::UpdateSiPMs()
+{
+    // The holes follow the back face of the crystal, they are moved when the
+    // crystal or the SiPM changes.
+    G4double fHoleDepth = 2*fSiPMDepth;
+    fHoleBox->SetXHalfLength(fSiPMSizeXY/2);
+    fHoleBox->SetYHalfLength(fSiPMSizeXY/2);
+    fHoleBox->SetZHalfLength(fHoleDepth);
+
+    fSiPMBox->SetXHalfLength(fSiPMSizeXY/2);
+    fSiPMBox->SetYHalfLength(fSiPMSizeXY/2);
+    fSiPMBox->SetZHalfLength(fSiPMDepth);
+
+    fPhotonDetBox->SetXHalfLength(fSiPMSizeXY/2);
+    fPhotonDetBox->SetYHalfLength(fSiPMSizeXY/2);
+    fPhotonDetBox->SetZHalfLength(fSiPMDepth/2);
+    fPhotonDetPhysical->SetTranslation(G4ThreeVector(0., 0., -fSiPMDepth/2.));
+
+    for (std::size_t i = 0; i < fHolePhysicals.size(); i++) {
+        fHolePhysicals[i]->SetTranslation(GetHolePosition(i/kNSiPMPerRow, i%kNSiPMPerRow));
+        fSiPMPhysicals[i]->SetTranslation(G4ThreeVector(0., 0., -fSiPMDepth));
+        if (fCheckOverlaps) fHolePhysicals[i]->CheckOverlaps();
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::UpdatePDE()
+{
+    // The PDE is only the efficiency of the photocathode surface
+    G4MaterialPropertyVector* efficiency = fPhotonDetSurfaceProperty->GetProperty("EFFICIENCY");
+    for (std::size_t i = 0; i < efficiency->GetVectorLength(); i++) {
+        efficiency->PutValue(i, fSiPM_PDE);
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void DetectorConstruction::PrintParameters()
 {
     // print parameters
@@ -423,12 +588,10 @@ void DetectorConstruction::PrintParameters()
 
 void DetectorConstruction::SetVerboseLevel(G4int val) {
     fVerboseLevel = val;
-    G4RunManager::GetRunManager()->ReinitializeGeometry();
 }
 
 void DetectorConstruction::SetSDVerboseLevel(G4int val) {
     fSDVerboseLevel = val;
-    G4RunManager::GetRunManager()->ReinitializeGeometry();
 }
 
 void DetectorConstruction::ValidateGeometry() {
@@ -436,34 +599,54 @@ void DetectorConstruction::ValidateGeometry() {
     G4RunManager::GetRunManager()->ReinitializeGeometry();
 }
 
+// The setters only record what has to be rebuilt, the geometry is changed
+// by UpdateGeometry() (/d2tb/det/update) once all the parameters are set.
+
 void DetectorConstruction::SetNCrystal(G4int val) {
+    if (val == fNCrystal) return;
     fNCrystal = val;
-    G4RunManager::GetRunManager()->ReinitializeGeometry();
+    fModified |= kLayoutModified;
 }
 
 void DetectorConstruction::SetCrystalSizeXY(G4double val) {
+    if (val == fCrystalSizeXY) return;
     fCrystalSizeXY = val;
-    G4RunManager::GetRunManager()->ReinitializeGeometry();
+    fModified |= kCrystalModified;
 }
 
 void DetectorConstruction::SetCrystalDepth(G4double val) {
+    if (val == fCrystalDepth) return;
     fCrystalDepth = val;
-    G4RunManager::GetRunManager()->ReinitializeGeometry();
+    fModified |= kCrystalModified;
 }
 
 void DetectorConstruction::SetSiPMSizeXY(G4double val) {
+    if (val == fSiPMSizeXY) return;
     fSiPMSizeXY = val;
-    G4RunManager::GetRunManager()->ReinitializeGeometry();
+    fModified |= kSiPMModified;
 }
 
 void DetectorConstruction::SetSiPMDepth(G4double val) {
+    if (val == fSiPMDepth) return;
     fSiPMDepth = val;
-    G4RunManager::GetRunManager()->ReinitializeGeometry();
+    fModified |= kSiPMModified;
 }
 
 void DetectorConstruction::SetSiPM_PDE(G4double val) {
+    if (val == fSiPM_PDE) return;
     fSiPM_PDE = val;
-    G4RunManager::GetRunManager()->ReinitializeGeometry();
+    fModified |= kSurfaceModified;
+}
+
+void DetectorConstruction::SetWorldKillEnergy(G4double val) {
+    //The limits are shared by the threads, they are only read during the events
+    fWorldKillEnergy = val;
+    fWorldLimits->SetUserMinEkine(val);
+}
+
+G4Region* DetectorConstruction::GetWorldRegion() const
+{
+    return fWorldLogical ? fWorldLogical->GetRegion() : nullptr;
 }
 
 G4double DetectorConstruction::GetCrystalEnd()
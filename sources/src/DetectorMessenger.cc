@@ -28,7 +28,12 @@ fCrystalSizeXYCmd(0),
 fCrystalDepthCmd(0),
 fSiPMSizeXYCmd(0),
 fSiPMDepthCmd(0),
-fSiPMPDECmd(0)
+fSiPMPDECmd(0),
+fUpdateCmd(0),
+fKillPhotonsInWorldCmd(0),
+fWorldKillEnergyCmd(0),
+fShowerCmd(0),
+fShowerThresholdCmd(0)
 {
     fDirectory = new G4UIdirectory("/d2tb/det/");
     fDirectory->SetGuidance(" Geometry Setup ");
@@ -96,6 +101,44 @@ fSiPMPDECmd(0)
     fSiPMPDECmd->SetRange("PDE>=0. && PDE <= 1.0");
     fSiPMPDECmd->AvailableForStates(G4State_PreInit,G4State_Idle);
     fSiPMPDECmd->SetToBeBroadcasted(false);
+
+    fUpdateCmd = new G4UIcmdWithoutParameter("/d2tb/det/update",this);
+    fUpdateCmd->SetGuidance("Apply the geometry parameters changed after /run/initialize.");
+    fUpdateCmd->SetGuidance("Only the volumes affected by the changes are modified.");
+    fUpdateCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+    fUpdateCmd->SetToBeBroadcasted(false);
+
+    fKillPhotonsInWorldCmd = new G4UIcmdWithABool("/d2tb/det/killPhotonsInWorld",this);
+    fKillPhotonsInWorldCmd->SetGuidance("Kill the optical photons leaving the crystals or the SiPMs for the world.");
+    fKillPhotonsInWorldCmd->SetParameterName("kill", true);
+    fKillPhotonsInWorldCmd->SetDefaultValue(true);
+    fKillPhotonsInWorldCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+    fKillPhotonsInWorldCmd->SetToBeBroadcasted(false);
+
+    fWorldKillEnergyCmd = new G4UIcmdWithADoubleAndUnit("/d2tb/det/worldKillEnergy",this);
+    fWorldKillEnergyCmd->SetGuidance("Kill the particles in the world volume below this kinetic energy.");
+    fWorldKillEnergyCmd->SetGuidance("Set it to zero to keep them (the optical photons are not concerned).");
+    fWorldKillEnergyCmd->SetParameterName("energy", false);
+    fWorldKillEnergyCmd->SetUnitCategory("Energy");
+    fWorldKillEnergyCmd->SetRange("energy>=0");
+    fWorldKillEnergyCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+    fWorldKillEnergyCmd->SetToBeBroadcasted(false);
+
+    fShowerCmd = new G4UIcmdWithABool("/d2tb/det/showerParameterisation",this);
+    fShowerCmd->SetGuidance("Parameterise the e+/e- showers in the crystals (GFlash), before /run/initialize.");
+    fShowerCmd->SetGuidance("The scintillation photons are produced from the energy spots of the showers.");
+    fShowerCmd->SetParameterName("use", true);
+    fShowerCmd->SetDefaultValue(true);
+    fShowerCmd->AvailableForStates(G4State_PreInit);
+    fShowerCmd->SetToBeBroadcasted(false);
+
+    fShowerThresholdCmd = new G4UIcmdWithADoubleAndUnit("/d2tb/det/showerThreshold",this);
+    fShowerThresholdCmd->SetGuidance("Set the minimum energy of the parameterised e+/e- (100 MeV by default).");
+    fShowerThresholdCmd->SetParameterName("energy", false);
+    fShowerThresholdCmd->SetUnitCategory("Energy");
+    fShowerThresholdCmd->SetRange("energy>0");
+    fShowerThresholdCmd->AvailableForStates(G4State_PreInit);
+    fShowerThresholdCmd->SetToBeBroadcasted(false);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -112,6 +155,11 @@ DetectorMessenger::~DetectorMessenger()
     delete fSiPMSizeXYCmd;
     delete fSiPMDepthCmd;
     delete fSiPMPDECmd;
+    delete fUpdateCmd;
+    delete fKillPhotonsInWorldCmd;
+    delete fWorldKillEnergyCmd;
+    delete fShowerCmd;
+    delete fShowerThresholdCmd;
 }
 
 void DetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
@@ -144,6 +192,21 @@ void DetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
     else if( command == fSiPMPDECmd ) {
         fDetector->SetSiPM_PDE(fSiPMPDECmd->GetNewDoubleValue(newValue));
     }
+    else if( command == fUpdateCmd ) {
+        fDetector->UpdateGeometry();
+    }
+    else if( command == fKillPhotonsInWorldCmd ) {
+        fDetector->SetKillPhotonsInWorld(fKillPhotonsInWorldCmd->GetNewBoolValue(newValue));
+    }
+    else if( command == fWorldKillEnergyCmd ) {
+        fDetector->SetWorldKillEnergy(fWorldKillEnergyCmd->GetNewDoubleValue(newValue));
+    }
+    else if( command == fShowerCmd ) {
+        fDetector->SetShowerParameterisation(fShowerCmd->GetNewBoolValue(newValue));
+    }
+    else if( command == fShowerThresholdCmd ) {
+        fDetector->SetShowerThreshold(fShowerThresholdCmd->GetNewDoubleValue(newValue));
+    }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -175,6 +238,18 @@ G4String DetectorMessenger::GetCurrentValue(G4UIcommand * command)
     else if( command == fSiPMPDECmd ) {
         ans=fSiPMPDECmd->ConvertToString(fDetector->GetSiPM_PDE());
     }
+    else if( command == fKillPhotonsInWorldCmd ) {
+        ans=fKillPhotonsInWorldCmd->ConvertToString(fDetector->GetKillPhotonsInWorld());
+    }
+    else if( command == fWorldKillEnergyCmd ) {
+        ans=fWorldKillEnergyCmd->ConvertToString(fDetector->GetWorldKillEnergy(), "MeV");
+    }
+    else if( command == fShowerCmd ) {
+        ans=fShowerCmd->ConvertToString(fDetector->GetShowerParameterisation());
+    }
+    else if( command == fShowerThresholdCmd ) {
+        ans=fShowerThresholdCmd->ConvertToString(fDetector->GetShowerThreshold(), "MeV");
+    }
 
     return ans;
 }
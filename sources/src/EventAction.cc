@@ -3,25 +3,28 @@
 
 #include "EventAction.hh"
 #include "D2TBRun.hh"
-#include "Trajectory.hh"
 #include "PhotonDetHit.hh"
+#include "Logger.hh"
+#include "GenstepManager.hh"
+#include "TrajectoryPolicy.hh"
 
 #include "G4Event.hh"
 #include "G4EventManager.hh"
 #include "G4RunManager.hh"
 #include "G4SDManager.hh"
-#include "G4TrajectoryContainer.hh"
-#include "G4Trajectory.hh"
+#include "G4HCofThisEvent.hh"
 #include "G4VVisManager.hh"
 #include "G4ios.hh"
 #include "G4UImanager.hh"
 #include "G4SystemOfUnits.hh"
 
+#include <algorithm>
+#include <map>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 EventAction::EventAction()
-: fVerboseLevel(1),
-fPhotonDetCollID(-1),
+: fPhotonDetCollID(-1),
 fHitCount(0),
 fPhotonCount_Scint(0),
 fAbsorptionCount(0),
@@ -49,28 +52,16 @@ void EventAction::BeginOfEventAction(const G4Event* evt)
     if(fPhotonDetCollID < 0)
     fPhotonDetCollID = SDman->GetCollectionID("PhotonDetHitCollection");
 
-    if(fVerboseLevel>0)
-    G4cout << "<<< Event " << evtNb << " started." << G4endl;
+    TrajectoryPolicy::StartEvent();
+
+    D2TB_LOG(kDebug) << "<<< Event " << evtNb << " started.";
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void EventAction::EndOfEventAction(const G4Event* evt)
 {
-    if (fVerboseLevel>0)
-    G4cout << "<<< Event " << evt->GetEventID() << " ended." << G4endl;
-
-    G4TrajectoryContainer* trajectoryContainer = evt->GetTrajectoryContainer();
-    G4int n_trajectories = 0;
-    if (trajectoryContainer) n_trajectories = trajectoryContainer->entries();
-
-    // extract the trajectories and draw them
-    if (G4VVisManager::GetConcreteInstance()) {
-        for (G4int i=0; i<n_trajectories; i++) {
-            Trajectory* trj = (Trajectory*)((*(evt->GetTrajectoryContainer()))[i]);
-            trj->DrawTrajectory();
-        }
-    }
+    D2TB_LOG(kDebug) << "<<< Event " << evt->GetEventID() << " ended.";
 
     G4HCofThisEvent* hitsCE = evt->GetHCofThisEvent();
     PhotonDetHitsCollection* SiPMHC = nullptr;
@@ -80,18 +71,120 @@ void EventAction::EndOfEventAction(const G4Event* evt)
         }
     }
 
+    // update the run statistics
+    D2TBRun* run = static_cast<D2TBRun*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+
+    // A sub-event only tracks optical photons of an event, its hits are
+    // merged in the event and counted with it.  Only the absorptions,
+    // which are not merged, are counted here.
+    if (IsSubEventWorker()) {
+        run->IncAbsorption(fAbsorptionCount);
+        run->IncBoundaryAbsorption(fBoundaryAbsorptionCount);
+        Logger::Flush();
+        return;
+    }
+
+    G4int nDetected = 0;
     if(SiPMHC){
-        G4int nhits = SiPMHC->entries();
-        fHitCount += nhits;
+        nDetected = SiPMHC->entries();
+        fHitCount += nDetected;
+        for (G4int i = 0; i < nDetected; i++) {
+            PhotonDetHit* hit = (*SiPMHC)[i];
+            run->AddDetectedPhoton(hit->GetCrystalNo(), hit->GetSiPMNo(), hit->GetArrivalTime());
+        }
     }
+    run->AddEventDetectedPhotons(nDetected);
 
-    // update the run statistics
-    D2TBRun* run = static_cast<D2TBRun*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+    // The trajectories are drawn by the vis manager, the hits are drawn as
+    // one marker per SiPM
+    if (SiPMHC && G4VVisManager::GetConcreteInstance()) MarkSiPMHits(SiPMHC);
+
+    // The scintillation photons of the gensteps recorded, replayed or
+    // generated by batches are counted from the gensteps, so that all the
+    // modes count the same photons
+    if (GenstepManager::IsRecording() || GenstepManager::GetMode() == GenstepManager::kReplay) {
+        fPhotonCount_Scint = GenstepManager::GetNumberOfPhotons();
+    }
 
     run->IncHitCount(fHitCount);
     run->IncPhotonCount_Scint(fPhotonCount_Scint);
     run->IncAbsorption(fAbsorptionCount);
     run->IncBoundaryAbsorption(fBoundaryAbsorptionCount);
+
+    // write the messages of this event in one block
+    Logger::Flush();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EventAction::IsSubEventWorker()
+{
+#if G4VERSION_NUMBER >= 1120
+    return G4RunManager::GetRunManager()->GetRunManagerType() == G4RunManager::subEventWorkerRM;
+#else
+    return false;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::MarkSiPMHits(PhotonDetHitsCollection* SiPMHC)
+{
+    // The first hit of each SiPM carries the marker of all its hits
+    std::map<std::pair<G4int, G4int>, PhotonDetHit*> first;
+    std::map<std::pair<G4int, G4int>, G4int> counts;
+    G4int maxCount = 0;
+    for (std::size_t i = 0; i < SiPMHC->GetSize(); i++) {
+        PhotonDetHit* hit = (*SiPMHC)[i];
+        auto sipm = std::make_pair(hit->GetCrystalNo(), hit->GetSiPMNo());
+        if (!first.count(sipm)) first[sipm] = hit;
+        maxCount = std::max(maxCount, ++counts[sipm]);
+        hit->SetSiPMHits(0, 0.);
+    }
+
+    for (const auto& sipm : first) {
+        G4int count = counts[sipm.first];
+        sipm.second->SetSiPMHits(count, G4double(count)/maxCount);
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#if G4VERSION_NUMBER >= 1120
+void EventAction::MergeSubEvent(G4Event* masterEvent, const G4Event* subEvent)
+{
+    G4SDManager* SDman = G4SDManager::GetSDMpointer();
+    if(fPhotonDetCollID < 0)
+    fPhotonDetCollID = SDman->GetCollectionID("PhotonDetHitCollection");
+    if(fPhotonDetCollID < 0) return;
+
+    G4HCofThisEvent* subHCE = subEvent->GetHCofThisEvent();
+    if(!subHCE) return;
+    PhotonDetHitsCollection* subHC = (PhotonDetHitsCollection*)(subHCE->GetHC(fPhotonDetCollID));
+    if(!subHC) return;
+
+    // The event may have no hit of its own yet (its photons are all tracked
+    // in sub-events), its collection is then created with the first ones.
+    G4HCofThisEvent* masterHCE = masterEvent->GetHCofThisEvent();
+    if(!masterHCE) {
+        masterHCE = new G4HCofThisEvent(SDman->GetCollectionCapacity());
+        masterEvent->SetHCofThisEvent(masterHCE);
+    }
+    PhotonDetHitsCollection* masterHC = (PhotonDetHitsCollection*)(masterHCE->GetHC(fPhotonDetCollID));
+    if(!masterHC) {
+        masterHC = new PhotonDetHitsCollection(subHC->GetSDname(), subHC->GetName());
+        masterHCE->AddHitsCollection(fPhotonDetCollID, masterHC);
+    }
+
+    // The sub-event owns its hits, they are copied in the allocator of the
+    // thread owning the event.
+    for (std::size_t i = 0; i < subHC->GetSize(); i++) {
+        masterHC->insert(new PhotonDetHit(*(*subHC)[i]));
+    }
+
+    D2TB_LOG(kDebug) << "<<< Event " << masterEvent->GetEventID() << " merged "
+    << subHC->GetSize() << " hits of a sub-event.";
 }
+#endif
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,214 @@
+#include "GenstepManager.hh"
+#include "TG4Event.hh"
+
+#include "G4Event.hh"
+#include "G4Track.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4Geantino.hh"
+#include "G4Navigator.hh"
+#include "G4TransportationManager.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4AutoLock.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+
+#include <TROOT.h>
+#include <TChain.h>
+
+#include <algorithm>
+#include <map>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::atomic<G4int> GenstepManager::fMode(GenstepManager::kTrack);
+std::atomic<G4int> GenstepManager::fBatchSize(0);
+G4String GenstepManager::fInput;
+
+G4ThreadLocal std::vector<Genstep>* GenstepManager::fGensteps = nullptr;
+G4ThreadLocal std::size_t GenstepManager::fNextGenstep = 0;
+G4ThreadLocal G4int GenstepManager::fNextPhoton = 0;
+
+namespace {
+    const char* kModeNames[] = { "track", "record", "replay" };
+
+    // The input is shared by the threads, each event is read under the lock
+    G4Mutex inputMutex = G4MUTEX_INITIALIZER;
+    TChain* input = nullptr;
+    TG4Event* inputEvent = nullptr;
+    std::map<G4int, Long64_t> inputEntries;
+
+    // Navigator of the thread to find the scintillator of the gensteps read
+    G4ThreadLocal G4Navigator* navigator = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String GenstepManager::GetModeName(G4int mode)
+{
+    if (mode < kTrack || mode > kReplay) return "";
+    return kModeNames[mode];
+}
+
+G4int GenstepManager::GetModeFromName(const G4String& name)
+{
+    for (G4int mode = kTrack; mode <= kReplay; mode++) {
+        if (name == kModeNames[mode]) return mode;
+    }
+    return kTrack;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<Genstep>* GenstepManager::GetBuffer()
+{
+    if (!fGensteps) fGensteps = new std::vector<Genstep>;
+    return fGensteps;
+}
+
+void GenstepManager::Clear()
+{
+    GetBuffer()->clear();
+    fNextGenstep = 0;
+    fNextPhoton = 0;
+}
+
+G4int GenstepManager::GetNumberOfPhotons()
+{
+    G4int nPhotons = 0;
+    for (const auto& genstep : GetGensteps()) nPhotons += genstep.fNumPhotons;
+    return nPhotons;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void GenstepManager::AddMarker(G4Event* anEvent)
+{
+    G4PrimaryParticle* particle = new G4PrimaryParticle(G4Geantino::GeantinoDefinition());
+    particle->SetKineticEnergy(0.);
+
+    G4PrimaryVertex* vertex = new G4PrimaryVertex(G4ThreeVector(), 0.);
+    vertex->SetPrimary(particle);
+    anEvent->AddPrimaryVertex(vertex);
+}
+
+G4bool GenstepManager::IsMarker(const G4Track* aTrack)
+{
+    return aTrack->GetParentID() == 0 && aTrack->GetKineticEnergy() == 0.
+    && aTrack->GetDefinition() == G4Geantino::GeantinoDefinition();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool GenstepManager::HasPendingPhotons()
+{
+    // Skip the gensteps whose photons were all generated, the gensteps
+    // recorded later in the event are appended
+    std::vector<Genstep>& gensteps = *GetBuffer();
+    while (fNextGenstep < gensteps.size() && fNextPhoton >= gensteps[fNextGenstep].fNumPhotons) {
+        fNextGenstep++;
+        fNextPhoton = 0;
+    }
+    return fNextGenstep < gensteps.size();
+}
+
+const Genstep* GenstepManager::TakePhotons(G4int n, G4int& nPhotons)
+{
+    nPhotons = 0;
+    if (n <= 0 || !HasPendingPhotons()) return nullptr;
+
+    const Genstep& genstep = (*fGensteps)[fNextGenstep];
+    nPhotons = std::min(n, genstep.fNumPhotons - fNextPhoton);
+    fNextPhoton += nPhotons;
+
+    return &genstep;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool GenstepManager::SetInput(const G4String& filename)
+{
+    G4AutoLock lock(&inputMutex);
+
+    delete input;
+    input = nullptr;
+    inputEntries.clear();
+    fInput = "";
+
+    // The output may also be written by the worker threads
+    ROOT::EnableThreadSafety();
+
+    TChain* chain = new TChain("SimEvents");
+    if (chain->Add(filename.c_str()) == 0 || !chain->GetBranch("Gensteps")) {
+        delete chain;
+        G4ExceptionDescription msg;
+        msg << "No recorded gensteps in " << filename;
+        G4Exception("GenstepManager::SetInput()", "Genstep0001", JustWarning, msg);
+        return false;
+    }
+
+    // Only the event ids are read to find the entries of the events
+    chain->SetBranchAddress("Event", &inputEvent);
+    chain->SetBranchStatus("*", 0);
+    chain->SetBranchStatus("EventId", 1);
+    Long64_t nEntries = chain->GetEntries();
+    for (Long64_t entry = 0; entry < nEntries; entry++) {
+        chain->GetEntry(entry);
+        inputEntries[inputEvent->EventId] = entry;
+    }
+    chain->SetBranchStatus("Gensteps*", 1);
+
+    input = chain;
+    fInput = filename;
+
+    G4cout << "GenstepManager::SetInput() : " << inputEntries.size() << " recorded events in "
+    << filename << G4endl;
+
+    return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool GenstepManager::ReadEvent(G4int eventId)
+{
+    std::vector<Genstep>& gensteps = *GetBuffer();
+    gensteps.clear();
+
+    {
+        G4AutoLock lock(&inputMutex);
+
+        if (!input) return false;
+        auto entry = inputEntries.find(eventId);
+        if (entry == inputEntries.end() || input->GetEntry(entry->second) <= 0) return false;
+
+        gensteps.resize(inputEvent->Gensteps.size());
+        for (std::size_t i = 0; i < gensteps.size(); i++) {
+            const TG4Genstep& recorded = inputEvent->Gensteps[i];
+            Genstep& genstep = gensteps[i];
+
+            TLorentzVector start = recorded.GetStart();
+            TLorentzVector end = recorded.GetEnd();
+            genstep.fStart.set(start.X()*mm, start.Y()*mm, start.Z()*mm);
+            genstep.fEnd.set(end.X()*mm, end.Y()*mm, end.Z()*mm);
+            genstep.fStartTime = start.T()*ns;
+            genstep.fEndTime = end.T()*ns;
+            genstep.fEnergyDeposit = recorded.GetEnergyDeposit()*MeV;
+            genstep.fNumPhotons = recorded.GetNumPhotons();
+            genstep.fTrackId = recorded.GetTrackId();
+            genstep.fPDGCode = recorded.GetPDGCode();
+        }
+    }
+
+    // The scintillator is the one at the middle of the step in the current
+    // geometry
+    if (!navigator) navigator = new G4Navigator();
+    navigator->SetWorldVolume(G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume());
+
+    for (auto& genstep : gensteps) {
+        G4VPhysicalVolume* volume = navigator->LocateGlobalPointAndSetup(0.5*(genstep.fStart + genstep.fEnd), nullptr, false, true);
+        genstep.fMaterial = volume ? volume->GetLogicalVolume()->GetMaterial() : nullptr;
+    }
+
+    return true;
+}
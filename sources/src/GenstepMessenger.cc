@@ -0,0 +1,77 @@
+#include "GenstepMessenger.hh"
+#include "GenstepManager.hh"
+
+#include <G4UIdirectory.hh>
+#include <G4UIcmdWithAString.hh>
+#include <G4UIcmdWithAnInteger.hh>
+
+GenstepMessenger::GenstepMessenger()
+{
+    fGenstepDIR = new G4UIdirectory("/d2tb/genstep/");
+    fGenstepDIR->SetGuidance("Simulation of the shower and of the optical photons in two stages.");
+
+    fModeCMD = new G4UIcmdWithAString("/d2tb/genstep/mode", this);
+    fModeCMD->SetGuidance("Select how the scintillation photons are simulated.");
+    fModeCMD->SetGuidance("  track  : tracked with the shower (default)");
+    fModeCMD->SetGuidance("  record : not tracked, the scintillating steps are written with the events");
+    fModeCMD->SetGuidance("  replay : only the photons of the steps of /d2tb/genstep/input are simulated");
+    fModeCMD->SetParameterName("mode", false);
+    fModeCMD->SetCandidates("track record replay");
+    fModeCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fModeCMD->SetToBeBroadcasted(false);
+
+    fInputCMD = new G4UIcmdWithAString("/d2tb/genstep/input", this);
+    fInputCMD->SetGuidance("Set the output of a recording job replayed (ROOT files, wildcards accepted).");
+    fInputCMD->SetGuidance("The event with a given id replays the recorded event with the same id.");
+    fInputCMD->SetParameterName("filename", false);
+    fInputCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fInputCMD->SetToBeBroadcasted(false);
+
+    fBatchSizeCMD = new G4UIcmdWithAnInteger("/d2tb/genstep/batchSize", this);
+    fBatchSizeCMD->SetGuidance("Generate the scintillation photons lazily, by batches of this size.");
+    fBatchSizeCMD->SetGuidance("The photons of each step are replaced by its genstep, the gensteps");
+    fBatchSizeCMD->SetGuidance("are only turned into photons once the stack is empty.");
+    fBatchSizeCMD->SetGuidance("0 stacks the photons of a step as soon as it is done (default).");
+    fBatchSizeCMD->SetParameterName("photons", false);
+    fBatchSizeCMD->SetRange("photons>=0");
+    fBatchSizeCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fBatchSizeCMD->SetToBeBroadcasted(false);
+}
+
+GenstepMessenger::~GenstepMessenger()
+{
+    delete fModeCMD;
+    delete fInputCMD;
+    delete fBatchSizeCMD;
+    delete fGenstepDIR;
+}
+
+void GenstepMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fModeCMD) {
+        GenstepManager::SetMode(GenstepManager::GetModeFromName(newValue));
+    }
+    else if (command == fInputCMD) {
+        GenstepManager::SetInput(newValue);
+    }
+    else if (command == fBatchSizeCMD) {
+        GenstepManager::SetBatchSize(G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+    }
+}
+
+G4String GenstepMessenger::GetCurrentValue(G4UIcommand * command)
+{
+    G4String currentValue;
+
+    if (command == fModeCMD) {
+        currentValue = GenstepManager::GetModeName(GenstepManager::GetMode());
+    }
+    else if (command == fInputCMD) {
+        currentValue = GenstepManager::GetInput();
+    }
+    else if (command == fBatchSizeCMD) {
+        currentValue = fBatchSizeCMD->ConvertToString(GenstepManager::GetBatchSize());
+    }
+
+    return currentValue;
+}
@@ -0,0 +1,112 @@
+#include "Logger.hh"
+
+#include "G4ios.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::atomic<G4int> Logger::fLevel(Logger::kInfo);
+std::atomic<G4int> Logger::fRateLimit(10);
+
+G4ThreadLocal std::ostringstream* Logger::fBuffer = nullptr;
+G4ThreadLocal std::map<const char*, G4int>* Logger::fTagCounts = nullptr;
+
+namespace {
+    // Flush the buffer before it grows beyond this size (in bytes).
+    const std::streamoff kMaxBufferSize = 64*1024;
+
+    const char* kLevelNames[] = { "error", "warning", "info", "debug" };
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String Logger::GetLevelName(G4int level)
+{
+    if (level < kError) level = kError;
+    if (level > kDebug) level = kDebug;
+    return kLevelNames[level];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int Logger::GetLevelFromName(const G4String& name)
+{
+    for (G4int level = kError; level <= kDebug; level++) {
+        if (name == kLevelNames[level]) return level;
+    }
+    return kInfo;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::ostringstream* Logger::GetBuffer()
+{
+    if (!fBuffer) fBuffer = new std::ostringstream;
+    return fBuffer;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Logger::Allow(const char* tag)
+{
+    if (!fTagCounts) fTagCounts = new std::map<const char*, G4int>;
+
+    G4int count = ++(*fTagCounts)[tag];
+    G4int limit = fRateLimit.load(std::memory_order_relaxed);
+
+    return (limit <= 0 || count <= limit);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Logger::Flush()
+{
+    if (!fBuffer || fBuffer->tellp() <= 0) return;
+
+    G4String text = fBuffer->str();
+    if (text[text.size()-1] == '\n') text.erase(text.size()-1);
+    G4cout << text << G4endl;
+
+    fBuffer->str("");
+    fBuffer->clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Logger::BeginOfRun()
+{
+    if (fTagCounts) fTagCounts->clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Logger::EndOfRun()
+{
+    G4int limit = fRateLimit;
+    if (fTagCounts && limit > 0) {
+        for (const auto& tag : *fTagCounts) {
+            if (tag.second <= limit) continue;
+            *GetBuffer() << "[" << GetLevelName(kInfo) << "] " << tag.first << " : "
+            << tag.second - limit << " more messages suppressed" << "\n";
+        }
+    }
+    Flush();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Logger::Message::Message(Level level)
+: fMessageLevel(level),
+fStream(Logger::GetBuffer())
+{
+    *fStream << "[" << GetLevelName(level) << "] ";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Logger::Message::~Message()
+{
+    *fStream << "\n";
+
+    // Errors are never delayed
+    if (fMessageLevel == kError || fStream->tellp() > kMaxBufferSize) Logger::Flush();
+}
@@ -0,0 +1,59 @@
+#include "LoggerMessenger.hh"
+#include "Logger.hh"
+
+#include <G4UIdirectory.hh>
+#include <G4UIcmdWithAString.hh>
+#include <G4UIcmdWithAnInteger.hh>
+
+LoggerMessenger::LoggerMessenger()
+{
+    fLogDIR = new G4UIdirectory("/d2tb/log/");
+    fLogDIR->SetGuidance("Logging of the user actions.");
+
+    fLevelCMD = new G4UIcmdWithAString("/d2tb/log/level", this);
+    fLevelCMD->SetGuidance("Set the level of the messages printed by the user actions.");
+    fLevelCMD->SetGuidance("The per event messages are printed at the debug level.");
+    fLevelCMD->SetParameterName("level", false);
+    fLevelCMD->SetCandidates("error warning info debug");
+    fLevelCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fLevelCMD->SetToBeBroadcasted(false);
+
+    fRateLimitCMD = new G4UIcmdWithAnInteger("/d2tb/log/rateLimit", this);
+    fRateLimitCMD->SetGuidance("Set the number of repeated messages printed per thread and run.");
+    fRateLimitCMD->SetGuidance("Set this number to zero if you don't want to limit");
+    fRateLimitCMD->SetParameterName("limit", false);
+    fRateLimitCMD->SetRange("limit>=0");
+    fRateLimitCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fRateLimitCMD->SetToBeBroadcasted(false);
+}
+
+LoggerMessenger::~LoggerMessenger()
+{
+    delete fLevelCMD;
+    delete fRateLimitCMD;
+    delete fLogDIR;
+}
+
+void LoggerMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fLevelCMD) {
+        Logger::SetLevel(Logger::GetLevelFromName(newValue));
+    }
+    else if (command == fRateLimitCMD) {
+        Logger::SetRateLimit(fRateLimitCMD->GetNewIntValue(newValue));
+    }
+}
+
+G4String LoggerMessenger::GetCurrentValue(G4UIcommand * command)
+{
+    G4String currentValue;
+
+    if (command == fLevelCMD) {
+        currentValue = Logger::GetLevelName(Logger::GetLevel());
+    }
+    else if (command == fRateLimitCMD) {
+        currentValue = fRateLimitCMD->ConvertToString(Logger::GetRateLimit());
+    }
+
+    return currentValue;
+}
@@ -0,0 +1,128 @@
+#include "MultiProcessRunner.hh"
+#include "PersistencyManager.hh"
+#include "SeedManager.hh"
+
+#include "TG4OutputMerger.hh"
+
+#include "G4RunManager.hh"
+#include "G4UIcommand.hh"
+#include "G4ios.hh"
+
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MultiProcessRunner::MultiProcessRunner(PersistencyManager* persistencyManager, G4int nProcesses)
+: fPersistencyManager(persistencyManager),
+fProcesses(nProcesses)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MultiProcessRunner::~MultiProcessRunner()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String MultiProcessRunner::GetProcessFilename(const G4String& output, G4int k)
+{
+    G4String base = output;
+    std::size_t ext = base.rfind(".root");
+    if (ext != std::string::npos && ext + 5 == base.size()) base = base.substr(0, ext);
+
+    return base + "_p" + G4UIcommand::ConvertToString(k) + ".root";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool MultiProcessRunner::BeamOn(G4int nEvents, const G4String& output)
+{
+    G4RunManager* runManager = G4RunManager::GetRunManager();
+
+    // Build the physics tables once, before forking
+    runManager->BeamOn(0);
+
+    G4cout << "MultiProcessRunner -- Running " << nEvents << " events in "
+    << fProcesses << " processes" << G4endl;
+
+    // Flush before forking, the buffers would be written by every process
+    G4cout.flush();
+    std::cout.flush();
+
+    G4int firstEvent = SeedManager::GetFirstEvent();
+    std::vector<pid_t> children;
+    for (G4int k = 0; k < fProcesses; k++) {
+        // Event range of the k-th process
+        G4int begin = G4int((G4long(nEvents)*k)/fProcesses);
+        G4int end = G4int((G4long(nEvents)*(k+1))/fProcesses);
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            G4ExceptionDescription msg;
+            msg << "Cannot fork the process " << k;
+            G4Exception("MultiProcessRunner::BeamOn()", "MultiProcess0001", FatalException, msg);
+            return false;
+        }
+        if (pid == 0) RunProcess(k, firstEvent + begin, end - begin, output);
+        children.push_back(pid);
+    }
+
+    G4bool success = true;
+    for (std::size_t k = 0; k < children.size(); k++) {
+        int status = 0;
+        waitpid(children[k], &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            G4cout << "MultiProcessRunner -- Process " << k << " failed" << G4endl;
+            success = false;
+        }
+    }
+
+    if (!success) {
+        G4cout << "MultiProcessRunner -- The outputs of the processes are not merged" << G4endl;
+        return false;
+    }
+
+    TG4OutputMerger merger;
+    for (G4int k = 0; k < fProcesses; k++) merger.AddFile(GetProcessFilename(output, k));
+    if (!merger.Merge(output)) {
+        G4cout << "MultiProcessRunner -- Cannot merge the outputs in " << output << G4endl;
+        return false;
+    }
+
+    for (G4int k = 0; k < fProcesses; k++) std::remove(GetProcessFilename(output, k).c_str());
+
+    for (const auto& run : merger.GetRunSummaries()) {
+        G4cout << "\n ======================== Run Summary ======================\n";
+        G4cout << "Run " << run.first << " : " << run.second.Events << " events in "
+        << fProcesses << " processes, written in " << output << G4endl;
+        G4cout << "Detected photons per event (mean, sigma):\t " << run.second.DetectedMean
+        << " " << run.second.GetDetectedSigma() << G4endl;
+        G4cout << "Resolution (sigma/mean):\t " << run.second.GetResolution() << G4endl;
+    }
+
+    return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MultiProcessRunner::RunProcess(G4int k, G4int first, G4int nEvents, const G4String& output)
+{
+    SeedManager::SetFirstEvent(first);
+
+    G4int status = 0;
+    if (fPersistencyManager) fPersistencyManager->Open(GetProcessFilename(output, k));
+    if (nEvents > 0) G4RunManager::GetRunManager()->BeamOn(nEvents);
+    if (fPersistencyManager && !fPersistencyManager->Close()) status = 1;
+
+    G4cout.flush();
+    std::cout.flush();
+
+    // Leave without running the destructors of the parent objects
+    _exit(status);
+}
@@ -3,6 +3,10 @@
 #include "PhotonDetHit.hh"
 #include "RunAction.hh"
 #include "D2TBRun.hh"
+#include "Logger.hh"
+#include "SeedManager.hh"
+#include "GenstepManager.hh"
+#include "Trajectory.hh"
 
 #include <G4ios.hh>
 #include <G4RunManager.hh>
@@ -14,14 +18,26 @@
 #include <G4ParticleTable.hh>
 #include <G4SDManager.hh>
 #include <G4HCtable.hh>
+#include <G4TrajectoryContainer.hh>
+#include <G4VTrajectory.hh>
+#include <G4VTrajectoryPoint.hh>
 
 #include <G4SystemOfUnits.hh>
 #include <G4PhysicalConstants.hh>
 
+#include <algorithm>
 #include <memory>
 
 PersistencyManager::PersistencyManager()
 : G4VPersistencyManager(),
+fMaxEventsPerFile(0),
+fMaxFileSize(0),
+fReducedOutput(false),
+fCheckpointing(false),
+fSaveTrajectories(false),
+fTrajectoryDecimation(kDouglasPeucker),
+fTrajectoryTolerance(0.1*mm),
+fTrajectoryStride(10),
 fFilename("/dev/null")
 {
     fPersistencyMessenger = new PersistencyMessenger(this);
@@ -46,6 +62,7 @@ G4bool PersistencyManager::Close(void)
 
 G4bool PersistencyManager::Store(const G4Event* anEvent)
 {
+    if (fReducedOutput) return false;
     UpdateSummaries(anEvent);
     return false;
 }
@@ -67,22 +84,28 @@ void PersistencyManager::UpdateSummaries(const G4Event* event) {
 
     fEventSummary.RunId = runInfo->GetRunID();
     fEventSummary.NScint = runInfo->GetPhotonCount_Scint();
-    fEventSummary.EventId = event->GetEventID();
-    G4cout << "PersistencyManager::UpdateSummaries() : Event Summary for run " << fEventSummary.RunId << " event " << fEventSummary.EventId << G4endl;
+    fEventSummary.EventId = SeedManager::GetEventId(event);
+    D2TB_LOG(kDebug) << "PersistencyManager::UpdateSummaries() : Event Summary for run " << fEventSummary.RunId << " event " << fEventSummary.EventId;
 
     SummarizeHitDetectors(fEventSummary.Detectors, event);
+    SummarizeTrajectories(fEventSummary.Trajectories, event);
+    SummarizeGensteps(fEventSummary.Gensteps);
 }
 
 void PersistencyManager::SummarizeHitDetectors( TG4HitDetectors& dest, const G4Event* event)
 {
-    dest.clear();
     G4HCofThisEvent* HCofEvent = event->GetHCofThisEvent();
-    if (!HCofEvent) return;
+    if (!HCofEvent) {
+        dest.clear();
+        return;
+    }
 
     G4SDManager *sdM = G4SDManager::GetSDMpointer();
     G4HCtable *hcT = sdM->GetHCtable();
 
-    // Copy each of the hit categories into the output event.
+    // Copy each of the hit categories into the output event.  The containers
+    // of the previous event are kept and their hits overwritten, only the
+    // detectors without hits in this event are removed.
     for (int i = 0; i < hcT->entries(); ++i)
     {
         G4String SDname = hcT->GetSDname(i);
@@ -91,10 +114,10 @@ void PersistencyManager::SummarizeHitDetectors( TG4HitDetectors& dest, const G4E
         int HCId = sdM->GetCollectionID(SDname+"/"+HCname);
         G4VHitsCollection* g4Hits = HCofEvent->GetHC(HCId);
 
-        if (g4Hits->GetSize() < 1) continue;
-
-        PhotonDetHit* hitSeg = dynamic_cast<PhotonDetHit*>(g4Hits->GetHit(0));
-        if (!hitSeg) continue;
+        if (!g4Hits || g4Hits->GetSize() < 1 || !dynamic_cast<PhotonDetHit*>(g4Hits->GetHit(0))) {
+            dest.erase(SDname);
+            continue;
+        }
 
         SummarizeHits(dest[SDname], g4Hits);
     }
@@ -102,16 +125,22 @@ void PersistencyManager::SummarizeHitDetectors( TG4HitDetectors& dest, const G4E
 
 void PersistencyManager::SummarizeHits(TG4PhotonDetHitContainer& dest, G4VHitsCollection* g4Hits)
 {
-    dest.clear();
     PhotonDetHit* g4Hit = dynamic_cast<PhotonDetHit*>(g4Hits->GetHit(0));
-    if (!g4Hit) return;
+    if (!g4Hit) {
+        dest.clear();
+        return;
+    }
 
-    G4cout << "PersistencyManager::SummarizeHits() : Number of photons hitting the SiPMs " << g4Hits->GetSize() << G4endl;
+    D2TB_LOG(kDebug) << "PersistencyManager::SummarizeHits() : Number of photons hitting the SiPMs " << g4Hits->GetSize();
+
+    // Every field is overwritten, the hits left in the container by the
+    // previous event are reused as they are.
+    dest.resize(g4Hits->GetSize());
 
     for (std::size_t h = 0; h < g4Hits->GetSize(); ++h)
     {
-        g4Hit = dynamic_cast<PhotonDetHit*>(g4Hits->GetHit(h));
-        TG4PhotonDetHit hit;
+        g4Hit = static_cast<PhotonDetHit*>(g4Hits->GetHit(h));
+        TG4PhotonDetHit& hit = dest[h];
 
         hit.fArrivalTime = g4Hit->GetArrivalTime();
         hit.fCrystalNo = g4Hit->GetCrystalNo();
@@ -120,7 +149,103 @@ void PersistencyManager::SummarizeHits(TG4PhotonDetHitContainer& dest, G4VHitsCo
         hit.fPosExit.SetXYZ(g4Hit->GetExitPos().x(), g4Hit->GetExitPos().y(), g4Hit->GetExitPos().z());
         hit.fPosArrive.SetXYZ(g4Hit->GetArrivalPos().x(), g4Hit->GetArrivalPos().y(), g4Hit->GetArrivalPos().z());
         hit.fPosArriveLocal.SetXYZ(g4Hit->GetArrivalPosLocal().x(), g4Hit->GetArrivalPosLocal().y(), g4Hit->GetArrivalPosLocal().z());
+    }
+}
+
+void PersistencyManager::SummarizeTrajectories(TG4TrajectoryContainer& dest, const G4Event* event)
+{
+    dest.clear();
+    if (!fSaveTrajectories) return;
+
+    G4TrajectoryContainer* trajectories = event->GetTrajectoryContainer();
+    if (!trajectories) return;
+
+    G4int nTrajectories = trajectories->entries();
+    dest.reserve(nTrajectories);
+    for (G4int t = 0; t < nTrajectories; ++t)
+    {
+        const G4VTrajectory* g4Traj = (*trajectories)[t];
+        if (!fTrajectoryParticles.empty()
+        && !fTrajectoryParticles.count(g4Traj->GetParticleName())) continue;
+
+        dest.push_back(TG4Trajectory());
+        TG4Trajectory& traj = dest.back();
+
+        traj.fTrackId = g4Traj->GetTrackID();
+        traj.fParentId = g4Traj->GetParentID();
+        traj.fPDGCode = g4Traj->GetPDGEncoding();
+        G4ThreeVector momentum = g4Traj->GetInitialMomentum();
+        traj.fInitialMomentum[0] = momentum.x()/MeV;
+        traj.fInitialMomentum[1] = momentum.y()/MeV;
+        traj.fInitialMomentum[2] = momentum.z()/MeV;
+
+        DecimatePoints(traj.fPoints, g4Traj);
+    }
+
+    D2TB_LOG(kDebug) << "PersistencyManager::SummarizeTrajectories() : " << dest.size()
+    << " of " << nTrajectories << " trajectories saved";
+}
+
+void PersistencyManager::SummarizeGensteps(TG4GenstepContainer& dest)
+{
+    if (GenstepManager::GetMode() != GenstepManager::kRecord) {
+        dest.clear();
+        return;
+    }
+
+    const std::vector<Genstep>& gensteps = GenstepManager::GetGensteps();
+    dest.resize(gensteps.size());
+    for (std::size_t g = 0; g < gensteps.size(); ++g)
+    {
+        const Genstep& genstep = gensteps[g];
+        TG4Genstep& step = dest[g];
+
+        step.fTrackId = genstep.fTrackId;
+        step.fPDGCode = genstep.fPDGCode;
+        step.fNumPhotons = genstep.fNumPhotons;
+        step.fEnergyDeposit = genstep.fEnergyDeposit/MeV;
+        step.fStart[0] = genstep.fStart.x()/mm;
+        step.fStart[1] = genstep.fStart.y()/mm;
+        step.fStart[2] = genstep.fStart.z()/mm;
+        step.fStart[3] = genstep.fStartTime/ns;
+        step.fEnd[0] = genstep.fEnd.x()/mm;
+        step.fEnd[1] = genstep.fEnd.y()/mm;
+        step.fEnd[2] = genstep.fEnd.z()/mm;
+        step.fEnd[3] = genstep.fEndTime/ns;
+    }
+
+    D2TB_LOG(kDebug) << "PersistencyManager::SummarizeGensteps() : " << dest.size()
+    << " gensteps of " << GenstepManager::GetNumberOfPhotons() << " photons saved";
+}
+
+void PersistencyManager::DecimatePoints(std::vector<Float_t>& dest, const G4VTrajectory* g4Traj) const
+{
+    dest.clear();
+    G4int nPoints = g4Traj->GetPointEntries();
+    if (nPoints < 1) return;
+
+    std::vector<G4ThreeVector> points(nPoints);
+    for (G4int p = 0; p < nPoints; ++p) points[p] = g4Traj->GetPoint(p)->GetPosition();
+
+    std::vector<char> keep(nPoints, 0);
+    keep.front() = keep.back() = 1;
+
+    if (fTrajectoryDecimation == kNthPoint) {
+        G4int stride = std::max(fTrajectoryStride, 1);
+        for (G4int p = 0; p < nPoints; p += stride) keep[p] = 1;
+    }
+    else if (fTrajectoryDecimation == kDouglasPeucker && fTrajectoryTolerance > 0) {
+        Trajectory::DouglasPeucker(points, fTrajectoryTolerance, keep);
+    }
+    else {
+        std::fill(keep.begin(), keep.end(), 1);
+    }
 
-        dest.push_back(hit);
+    dest.reserve(3*std::count(keep.begin(), keep.end(), 1));
+    for (G4int p = 0; p < nPoints; ++p) {
+        if (!keep[p]) continue;
+        dest.push_back(points[p].x()/mm);
+        dest.push_back(points[p].y()/mm);
+        dest.push_back(points[p].z()/mm);
     }
 }
@@ -4,9 +4,23 @@
 #include <G4UIdirectory.hh>
 #include <G4UIcmdWithAString.hh>
 #include <G4UIcmdWithoutParameter.hh>
+#include <G4UIcmdWithAnInteger.hh>
+#include <G4UIcmdWithADouble.hh>
+#include <G4UIcmdWithADoubleAndUnit.hh>
+#include <G4UIcmdWithABool.hh>
 #include <G4UIcommand.hh>
+#include <G4UImanager.hh>
+#include <G4EventManager.hh>
+#include <G4TrackingManager.hh>
 #include <G4ios.hh>
 
+#include <set>
+#include <sstream>
+
+namespace {
+    const char* kDecimationNames[] = { "none", "douglasPeucker", "nth" };
+}
+
 PersistencyMessenger::PersistencyMessenger( PersistencyManager* persistencyMgr )
 : fPersistencyManager(persistencyMgr)
 {
@@ -21,12 +35,86 @@ PersistencyMessenger::PersistencyMessenger( PersistencyManager* persistencyMgr )
 
     fCloseCMD = new G4UIcmdWithoutParameter("/d2tb/root/close", this);
     fCloseCMD->SetGuidance("Close the output file.");
+
+    fMaxEventsCMD = new G4UIcmdWithAnInteger("/d2tb/root/maxEventsPerFile", this);
+    fMaxEventsCMD->SetGuidance("Start a new output file (name_NNNN.root) after this number of events.");
+    fMaxEventsCMD->SetGuidance("Set this number to zero to write a single file.");
+    fMaxEventsCMD->SetParameterName("events", false);
+    fMaxEventsCMD->SetRange("events>=0");
+    fMaxEventsCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fMaxSizeCMD = new G4UIcmdWithADouble("/d2tb/root/maxFileSize", this);
+    fMaxSizeCMD->SetGuidance("Start a new output file (name_NNNN.root) once the current one reaches this size in MB.");
+    fMaxSizeCMD->SetGuidance("The events still buffered are flushed every 5% of this size (at least 1 MB),");
+    fMaxSizeCMD->SetGuidance("the files can be larger by this much.");
+    fMaxSizeCMD->SetGuidance("Set this number to zero to write a single file.");
+    fMaxSizeCMD->SetParameterName("size", false);
+    fMaxSizeCMD->SetRange("size>=0");
+    fMaxSizeCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fModeCMD = new G4UIcmdWithAString("/d2tb/root/mode", this);
+    fModeCMD->SetGuidance("Select what is written in the output file.");
+    fModeCMD->SetGuidance("  events  : the event tree and the run summaries (default)");
+    fModeCMD->SetGuidance("  reduced : only the run summaries and histograms");
+    fModeCMD->SetParameterName("mode", false);
+    fModeCMD->SetCandidates("events reduced");
+    fModeCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fTrajectoryDIR = new G4UIdirectory("/d2tb/root/trajectory/");
+    fTrajectoryDIR->SetGuidance("Trajectories saved in the output file.");
+
+    fTrajectorySaveCMD = new G4UIcmdWithABool("/d2tb/root/trajectory/save", this);
+    fTrajectorySaveCMD->SetGuidance("Save the trajectories of the events in the event tree.");
+    fTrajectorySaveCMD->SetGuidance("This also switches on /tracking/storeTrajectory, the tracks");
+    fTrajectorySaveCMD->SetGuidance("which get a trajectory are selected by /d2tb/trajectory/store.");
+    fTrajectorySaveCMD->SetParameterName("save", true);
+    fTrajectorySaveCMD->SetDefaultValue(true);
+    fTrajectorySaveCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fTrajectoryDecimationCMD = new G4UIcmdWithAString("/d2tb/root/trajectory/decimation", this);
+    fTrajectoryDecimationCMD->SetGuidance("Select the points saved of each trajectory.");
+    fTrajectoryDecimationCMD->SetGuidance("  none           : all the points");
+    fTrajectoryDecimationCMD->SetGuidance("  douglasPeucker : the points needed to stay within the tolerance (default)");
+    fTrajectoryDecimationCMD->SetGuidance("  nth            : every n-th point (see stride)");
+    fTrajectoryDecimationCMD->SetGuidance("The first and last points are always saved.");
+    fTrajectoryDecimationCMD->SetParameterName("decimation", false);
+    fTrajectoryDecimationCMD->SetCandidates("none douglasPeucker nth");
+    fTrajectoryDecimationCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fTrajectoryToleranceCMD = new G4UIcmdWithADoubleAndUnit("/d2tb/root/trajectory/tolerance", this);
+    fTrajectoryToleranceCMD->SetGuidance("Set the largest distance of the saved trajectory to the full one (douglasPeucker).");
+    fTrajectoryToleranceCMD->SetParameterName("tolerance", false);
+    fTrajectoryToleranceCMD->SetRange("tolerance>=0");
+    fTrajectoryToleranceCMD->SetUnitCategory("Length");
+    fTrajectoryToleranceCMD->SetDefaultUnit("mm");
+    fTrajectoryToleranceCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fTrajectoryStrideCMD = new G4UIcmdWithAnInteger("/d2tb/root/trajectory/stride", this);
+    fTrajectoryStrideCMD->SetGuidance("Save every n-th point of the trajectories (nth).");
+    fTrajectoryStrideCMD->SetParameterName("n", false);
+    fTrajectoryStrideCMD->SetRange("n>=1");
+    fTrajectoryStrideCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fTrajectoryParticlesCMD = new G4UIcmdWithAString("/d2tb/root/trajectory/particles", this);
+    fTrajectoryParticlesCMD->SetGuidance("Only save the trajectories of these particles: <name> [<name> ...]");
+    fTrajectoryParticlesCMD->SetGuidance("Use all to save the trajectories of all the particles (default).");
+    fTrajectoryParticlesCMD->SetParameterName("particles", false);
+    fTrajectoryParticlesCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 
 PersistencyMessenger::~PersistencyMessenger()
 {
     delete fOpenCMD;
     delete fCloseCMD;
+    delete fMaxEventsCMD;
+    delete fMaxSizeCMD;
+    delete fModeCMD;
+    delete fTrajectorySaveCMD;
+    delete fTrajectoryDecimationCMD;
+    delete fTrajectoryToleranceCMD;
+    delete fTrajectoryStrideCMD;
+    delete fTrajectoryParticlesCMD;
+    delete fTrajectoryDIR;
     delete fPersistencyDIR;
 }
 
@@ -38,6 +126,45 @@ void PersistencyMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
     else if (command == fCloseCMD) {
         fPersistencyManager->Close();
     }
+    else if (command == fMaxEventsCMD) {
+        fPersistencyManager->SetMaxEventsPerFile(fMaxEventsCMD->GetNewIntValue(newValue));
+    }
+    else if (command == fMaxSizeCMD) {
+        fPersistencyManager->SetMaxFileSize(fMaxSizeCMD->GetNewDoubleValue(newValue)*1024*1024);
+    }
+    else if (command == fModeCMD) {
+        fPersistencyManager->SetReducedOutput(newValue == "reduced");
+    }
+    else if (command == fTrajectorySaveCMD) {
+        G4bool save = fTrajectorySaveCMD->GetNewBoolValue(newValue);
+        fPersistencyManager->SetSaveTrajectories(save);
+
+        // The trajectories only exist if the tracking stores them
+        G4EventManager* eventManager = G4EventManager::GetEventManager();
+        if (save && eventManager && !eventManager->GetTrackingManager()->GetStoreTrajectory()) {
+            G4UImanager::GetUIpointer()->ApplyCommand("/tracking/storeTrajectory 1");
+        }
+    }
+    else if (command == fTrajectoryDecimationCMD) {
+        for (G4int decimation = 0; decimation < 3; decimation++) {
+            if (newValue == kDecimationNames[decimation]) fPersistencyManager->SetTrajectoryDecimation(decimation);
+        }
+    }
+    else if (command == fTrajectoryToleranceCMD) {
+        fPersistencyManager->SetTrajectoryTolerance(fTrajectoryToleranceCMD->GetNewDoubleValue(newValue));
+    }
+    else if (command == fTrajectoryStrideCMD) {
+        fPersistencyManager->SetTrajectoryStride(fTrajectoryStrideCMD->GetNewIntValue(newValue));
+    }
+    else if (command == fTrajectoryParticlesCMD) {
+        std::set<G4String> particles;
+        std::istringstream is(newValue);
+        G4String name;
+        while (is >> name) {
+            if (name != "all") particles.insert(name);
+        }
+        fPersistencyManager->SetTrajectoryParticles(particles);
+    }
 }
 
 G4String PersistencyMessenger::GetCurrentValue(G4UIcommand * command)
@@ -47,6 +174,34 @@ G4String PersistencyMessenger::GetCurrentValue(G4UIcommand * command)
     if (command == fOpenCMD) {
         currentValue = fPersistencyManager->GetFilename();
     }
+    else if (command == fMaxEventsCMD) {
+        currentValue = fMaxEventsCMD->ConvertToString(fPersistencyManager->GetMaxEventsPerFile());
+    }
+    else if (command == fMaxSizeCMD) {
+        currentValue = fMaxSizeCMD->ConvertToString(fPersistencyManager->GetMaxFileSize()/(1024*1024));
+    }
+    else if (command == fModeCMD) {
+        currentValue = fPersistencyManager->GetReducedOutput() ? "reduced" : "events";
+    }
+    else if (command == fTrajectorySaveCMD) {
+        currentValue = fTrajectorySaveCMD->ConvertToString(fPersistencyManager->GetSaveTrajectories());
+    }
+    else if (command == fTrajectoryDecimationCMD) {
+        currentValue = kDecimationNames[fPersistencyManager->GetTrajectoryDecimation()];
+    }
+    else if (command == fTrajectoryToleranceCMD) {
+        currentValue = fTrajectoryToleranceCMD->ConvertToString(fPersistencyManager->GetTrajectoryTolerance(), "mm");
+    }
+    else if (command == fTrajectoryStrideCMD) {
+        currentValue = fTrajectoryStrideCMD->ConvertToString(fPersistencyManager->GetTrajectoryStride());
+    }
+    else if (command == fTrajectoryParticlesCMD) {
+        for (const auto& name : fPersistencyManager->GetTrajectoryParticles()) {
+            if (!currentValue.empty()) currentValue += " ";
+            currentValue += name;
+        }
+        if (currentValue.empty()) currentValue = "all";
+    }
 
     return currentValue;
 }
@@ -1,19 +1,41 @@
 #include "PersistencyRootManager.hh"
+#include "D2TBRun.hh"
+#include "Logger.hh"
 
 #include <globals.hh>
 
 #include <G4Event.hh>
 #include <G4Run.hh>
+#include <G4UIcommand.hh>
+#include <G4SystemOfUnits.hh>
 
 #include <TROOT.h>
 #include <TFile.h>
 #include <TTree.h>
+#include <TNamed.h>
+#include <TDirectory.h>
+#include <TKey.h>
+#include <TList.h>
+#include <TH1D.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
 
 
 PersistencyRootManager::PersistencyRootManager()
 : PersistencyManager(),
 fOutput(NULL),
-fEventTree(NULL)
+fEventTree(NULL),
+fRunTree(NULL),
+fEventsNotSaved(0),
+fFileIndex(0),
+fEventsInFile(0),
+fFirstEventId(-1),
+fLastEventId(-1),
+fEventPointer(&fEventSummary),
+fRunPointer(&fRunSummary)
 {}
 
 PersistencyRootManager::~PersistencyRootManager()
@@ -35,62 +57,347 @@ bool PersistencyRootManager::Open(G4String filename)
 {
     if (fOutput) {
         G4cout <<  "PersistencyRootManager::Open -- Delete current file pointer" << G4endl;
+        CloseFile();
     }
 
     SetFilename(filename);
+    fFileIndex = 0;
+
+    return OpenFile(GetFilename());
+}
+
+bool PersistencyRootManager::Close()
+{
+    if (!fOutput) {
+        G4cout << "PersistencyRootManager::Close -- No Output File" << G4endl;
+        return false;
+    }
+
+    return CloseFile();
+}
+
+G4String PersistencyRootManager::GetCurrentFilename(void) const
+{
+    if (fFileIndex == 0) return GetFilename();
+    return GetChunkFilename(fFileIndex);
+}
+
+bool PersistencyRootManager::Reopen(G4String filename, G4int fileIndex, G4int eventsInFile)
+{
+    if (fOutput) {
+        G4cout <<  "PersistencyRootManager::Reopen -- Delete current file pointer" << G4endl;
+        CloseFile();
+    }
+
+    SetFilename(filename);
+    fFileIndex = fileIndex;
+
+    if (!OpenFile(GetCurrentFilename(), "UPDATE")) return false;
+    if (eventsInFile < 0) return true;
+
+    // The files started after the checkpoint are written again
+    for (G4int index = fileIndex + 1; std::remove(GetChunkFilename(index).c_str()) == 0; ++index) {
+        G4cout << "PersistencyRootManager::Reopen -- Removed " << GetChunkFilename(index) << G4endl;
+    }
+
+    return TruncateEventTree(eventsInFile);
+}
+
+G4bool PersistencyRootManager::TruncateEventTree(Long64_t nEvents)
+{
+    if (!fEventTree || fEventTree->GetEntries() <= nEvents) return true;
+
+    G4cout << "PersistencyRootManager::TruncateEventTree -- Drop the "
+    << fEventTree->GetEntries() - nEvents << " events written after the checkpoint" << G4endl;
 
-    G4cout << "PersistencyRootManager::Open " << GetFilename() << G4endl;
-    
-    fOutput = TFile::Open(GetFilename(), "RECREATE", "Root Output");
     fOutput->cd();
 
-    fEventTree = new TTree("SimEvents", "Simulated Events");
+    // The first events are copied in a new tree, then the keys of the old
+    // one are removed from the file.
+    TTree* tree = fEventTree->CloneTree(0);
+    for (Long64_t entry = 0; entry < nEvents; ++entry) {
+        fEventTree->GetEntry(entry);
+        tree->Fill();
+    }
 
-    static TG4Event *pEvent = &fEventSummary;
-    fEventTree->Branch("Event","TG4Event",&pEvent);
+    std::vector<TKey*> keys;
+    TIter next(fOutput->GetListOfKeys());
+    while (TKey* key = static_cast<TKey*>(next())) {
+        if (std::string(key->GetName()) == "SimEvents") keys.push_back(key);
+    }
+    delete fEventTree;
+    for (auto key : keys) {
+        key->Delete();
+        delete key;
+    }
 
-    fEventsNotSaved = 0;
+    fEventTree = tree;
+    fEventTree->SetBranchAddress("Event", &fEventPointer);
+    if (fCheckpointing) fEventTree->SetAutoSave(0);
+    fEventTree->AutoSave("SaveSelf");
+
+    fEventsInFile = nEvents;
+    fFirstEventId = -1;
+    fLastEventId = -1;
+    if (fEventsInFile > 0) {
+        fEventTree->GetEntry(0);
+        fFirstEventId = fEventSummary.EventId;
+        fEventTree->GetEntry(fEventsInFile-1);
+        fLastEventId = fEventSummary.EventId;
+    }
 
     return true;
 }
 
-bool PersistencyRootManager::Close()
+bool PersistencyRootManager::Checkpoint()
 {
-    if (!fOutput) {
-        G4cout << "PersistencyRootManager::Close -- No Output File" << G4endl;
+    if (!fOutput) return false;
+
+    fOutput->cd();
+    if (fEventTree) fEventTree->AutoSave("SaveSelf");
+    if (fRunTree) fRunTree->AutoSave("SaveSelf");
+    fOutput->SaveSelf();
+    fOutput->Flush();
+
+    return true;
+}
+
+G4bool PersistencyRootManager::OpenFile(G4String filename, const char* option)
+{
+    G4cout << "PersistencyRootManager::Open " << filename << " (" << option << ")" << G4endl;
+
+    fOutput = TFile::Open(filename, option, "Root Output");
+    if (!fOutput || fOutput->IsZombie()) {
+        G4ExceptionDescription msg;
+        msg << "Cannot open output file " << filename;
+        G4Exception("PersistencyRootManager::OpenFile()",
+        "ErrorCode1", FatalException, msg);
         return false;
     }
+    fOutput->cd();
+
+    fEventTree = nullptr;
+    fRunTree = nullptr;
+
+    fEventsNotSaved = 0;
+    fEventsInFile = 0;
+    fFirstEventId = -1;
+    fLastEventId = -1;
+
+    // Continue the trees of an existing file, as they were at the last time
+    // they were saved.
+    fEventTree = dynamic_cast<TTree*>(fOutput->Get("SimEvents"));
+    if (fEventTree) {
+        fEventTree->SetBranchAddress("Event", &fEventPointer);
+        LimitBufferedBytes();
+        fEventsInFile = fEventTree->GetEntries();
+        if (fEventsInFile > 0) {
+            fEventTree->GetEntry(0);
+            fFirstEventId = fEventSummary.EventId;
+            fEventTree->GetEntry(fEventsInFile-1);
+            fLastEventId = fEventSummary.EventId;
+        }
+        if (fCheckpointing) fEventTree->SetAutoSave(0);
+    }
+
+    fRunTree = dynamic_cast<TTree*>(fOutput->Get("RunSummary"));
+    if (fRunTree) {
+        fRunTree->SetBranchAddress("Run", &fRunPointer);
+        if (fCheckpointing) fRunTree->SetAutoSave(0);
+    }
+
+    return true;
+}
 
+void PersistencyRootManager::CreateEventTree(void)
+{
     fOutput->cd();
 
+    fEventTree = new TTree("SimEvents", "Simulated Events");
+    fEventTree->Branch("Event","TG4Event",&fEventPointer);
+    if (fCheckpointing) fEventTree->SetAutoSave(0);
+    LimitBufferedBytes();
+}
+
+void PersistencyRootManager::LimitBufferedBytes(void)
+{
+    if (!fEventTree || fMaxFileSize <= 0) return;
+
+    // The size of the file only counts the baskets already written, the ones
+    // still in memory are flushed every 5% of the size limit (at least 1 MB,
+    // at most the 30 MB of ROOT) so that the files overshoot it by no more.
+    Long64_t bytes = std::min(Long64_t(fMaxFileSize/20), Long64_t(30*1024*1024));
+    fEventTree->SetAutoFlush(-std::max(bytes, Long64_t(1024*1024)));
+}
+
+G4bool PersistencyRootManager::CloseFile(void)
+{
+    fOutput->cd();
+
+    // Every file carries the run metadata so that it can be analysed on its
+    // own as soon as it is closed.
+    TNamed("RunId", G4UIcommand::ConvertToString(fEventSummary.RunId).c_str()).Write();
+    TNamed("FileIndex", G4UIcommand::ConvertToString(fFileIndex).c_str()).Write();
+    TNamed("FirstEventId", G4UIcommand::ConvertToString(fFirstEventId).c_str()).Write();
+    TNamed("LastEventId", G4UIcommand::ConvertToString(fLastEventId).c_str()).Write();
+    TNamed("BaseFilename", GetFilename().c_str()).Write();
+
     fOutput->Write();
     fOutput->Close();
 
+    delete fOutput;
+    fOutput = nullptr;
     fEventTree = nullptr;
+    fRunTree = nullptr;
 
     return true;
 }
 
+G4bool PersistencyRootManager::Rotate(void)
+{
+    G4cout << "PersistencyRootManager::Rotate -- Closing " << GetCurrentFilename()
+    << " after " << fEventsInFile << " events" << G4endl;
+
+    CloseFile();
+    ++fFileIndex;
+
+    return OpenFile(GetChunkFilename(fFileIndex));
+}
+
+G4bool PersistencyRootManager::NeedsRotation(void) const
+{
+    if (fMaxEventsPerFile > 0 && fEventsInFile >= fMaxEventsPerFile) return true;
+    if (fMaxFileSize > 0 && fOutput->GetEND() >= fMaxFileSize) return true;
+    return false;
+}
+
+G4String PersistencyRootManager::GetChunkFilename(int index) const
+{
+    G4String base = GetFilename();
+    std::size_t ext = base.rfind(".root");
+    if (ext != std::string::npos && ext + 5 == base.size()) base = base.substr(0, ext);
+
+    char suffix[16];
+    std::snprintf(suffix, sizeof(suffix), "_%04d.root", index);
+
+    return base + suffix;
+}
+
 bool PersistencyRootManager::Store(const G4Event* anEvent)
 {
+    if (fReducedOutput) return false;
+
     if (!fOutput) {
-        G4cout << "PersistencyRootManager::Store -- No Output File" << G4endl;
+        D2TB_LOG_LIMITED(kWarning, "PersistencyRootManager::Store") << "PersistencyRootManager::Store -- No Output File";
         return false;
     }
 
+    // Only start a new file when there is an event to put in it, so that the
+    // end of the run does not leave an empty file behind.
+    if (NeedsRotation()) Rotate();
+
     UpdateSummaries(anEvent);
 
+    if (!fEventTree) CreateEventTree();
+
     fOutput->cd();
 
     fEventTree->Fill();
 
+    if (fFirstEventId < 0) fFirstEventId = fEventSummary.EventId;
+    fLastEventId = fEventSummary.EventId;
+    ++fEventsInFile;
+
     return true;
 }
 
-bool PersistencyRootManager::Store(const G4Run*)
+bool PersistencyRootManager::Store(const G4Run* aRun)
 {
-    /* nop */
-    return false;
+    const D2TBRun* run = dynamic_cast<const D2TBRun*>(aRun);
+    if (!run) return false;
+
+    if (!fOutput) {
+        G4cout << "PersistencyRootManager::Store -- No Output File" << G4endl;
+        return false;
+    }
+
+    fOutput->cd();
+
+    // The blocks of a checkpointed job have one summary, stored by
+    // StoreSummary when the job is complete
+    if (!fCheckpointing) {
+        TG4RunSummary summary;
+        run->FillSummary(summary);
+        StoreSummary(summary);
+    }
+
+    WriteRunHistograms(run);
+
+    return true;
+}
+
+bool PersistencyRootManager::StoreSummary(const TG4RunSummary& summary)
+{
+    if (!fOutput) {
+        G4cout << "PersistencyRootManager::StoreSummary -- No Output File" << G4endl;
+        return false;
+    }
+
+    fOutput->cd();
+
+    fRunSummary = summary;
+
+    if (!fRunTree) {
+        fRunTree = new TTree("RunSummary", "Run Summaries");
+        fRunTree->Branch("Run","TG4RunSummary",&fRunPointer);
+        if (fCheckpointing) fRunTree->SetAutoSave(0);
+    }
+    fRunTree->Fill();
+
+    return true;
+}
+
+void PersistencyRootManager::WriteRunHistograms(const D2TBRun* run)
+{
+    G4String name = "Run_" + G4UIcommand::ConvertToString(run->GetRunID());
+    TDirectory* dir = fOutput->GetDirectory(name.c_str());
+    if (!dir) dir = fOutput->mkdir(name.c_str());
+    dir->cd();
+
+    G4double nEvents = std::max(run->GetDetectedEvents(), 1);
+
+    // Mean light yield of each crystal
+    const auto& yield = run->GetCrystalYield();
+    if (!yield.empty()) {
+        G4int first = yield.begin()->first;
+        G4int last = yield.rbegin()->first;
+        TH1D hYield("hPhotonsPerCrystal", "Detected photons per event and crystal;Crystal;Photons",
+        last-first+1, first-0.5, last+0.5);
+        for (const auto& crystal : yield) {
+            hYield.SetBinContent(hYield.FindBin(crystal.first), crystal.second/nEvents);
+        }
+        hYield.Write();
+    }
+
+    // Arrival time distribution of each SiPM
+    for (const auto& sipm : run->GetArrivalTimes()) {
+        G4String suffix = G4UIcommand::ConvertToString(sipm.first.first)
+        + "_" + G4UIcommand::ConvertToString(sipm.first.second);
+        G4String title = "Arrival time, crystal " + G4UIcommand::ConvertToString(sipm.first.first)
+        + " SiPM " + G4UIcommand::ConvertToString(sipm.first.second) + ";Time (ns);Photons";
+        TH1D hTime(("hArrivalTime_" + suffix).c_str(), title.c_str(),
+        D2TBRun::GetTimeBins(), 0., D2TBRun::GetTimeMax()/ns);
+
+        G4double entries = 0;
+        for (std::size_t i = 0; i < sipm.second.size(); ++i) {
+            hTime.SetBinContent(i, sipm.second[i]);
+            entries += sipm.second[i];
+        }
+        hTime.SetEntries(entries);
+        hTime.Write();
+    }
+
+    fOutput->cd();
 }
 
 bool PersistencyRootManager::Store(const G4VPhysicalVolume*)
@@ -7,6 +7,7 @@
 #include "G4AttDef.hh"
 #include "G4AttValue.hh"
 #include "G4Circle.hh"
+#include "G4UIcommand.hh"
 
 #include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
@@ -24,6 +25,8 @@ PhotonDetHit::PhotonDetHit()
     fLogicalVolume = nullptr;
     fCrystalNo = 0;
     fSiPMNo = 0;
+    fSiPMHits = 1;
+    fSiPMHitFraction = 1.;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -37,6 +40,8 @@ PhotonDetHit::PhotonDetHit(G4ThreeVector pExit, G4ThreeVector pArrive, G4ThreeVe
     fLogicalVolume = pLogV;
     fCrystalNo = pCrystalNo;
     fSiPMNo = pSiPMNo;
+    fSiPMHits = 1;
+    fSiPMHitFraction = 1.;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -62,6 +67,8 @@ const PhotonDetHit& PhotonDetHit::operator=(const PhotonDetHit &right)
     fLogicalVolume = right.fLogicalVolume;
     fCrystalNo = right.fCrystalNo;
     fSiPMNo = right.fSiPMNo;
+    fSiPMHits = right.fSiPMHits;
+    fSiPMHitFraction = right.fSiPMHitFraction;
 
     return *this;
 }
@@ -77,14 +84,18 @@ G4bool PhotonDetHit::operator==(const PhotonDetHit& right) const
 
 void PhotonDetHit::Draw()
 {
+    if (fSiPMHits <= 0) return;
+
     auto visManager = G4VVisManager::GetConcreteInstance();
     if ( ! visManager ) return;
 
+    // From a small blue marker for the fewest hits to a large red one for
+    // the SiPM with the most hits of the event
     G4Point3D p3D = G4Point3D(fPosArrive);
     G4Circle chit(p3D);
-    chit.SetScreenDiameter(4.0);
+    chit.SetScreenDiameter(4.0 + 12.0*fSiPMHitFraction);
     chit.SetFillStyle(G4Circle::filled);
-    G4Colour colour(1.,0.,0.);
+    G4Colour colour(fSiPMHitFraction,0.,1.-fSiPMHitFraction);
     G4VisAttributes attribs(colour);
     chit.SetVisAttributes(attribs);
     visManager->Draw(chit);
@@ -117,6 +128,9 @@ const std::map<G4String,G4AttDef>* PhotonDetHit::GetAttDefs() const
         (*store)["SiPMNo"] = G4AttDef("SiPMNo", "SiPM Number", "Physics","",
         "G4int");
 
+        (*store)["SiPMHits"] = G4AttDef("SiPMHits", "Hits of the SiPM in the event", "Physics","",
+        "G4int");
+
         (*store)["LVol"] = G4AttDef("LVol","Logical Volume","Physics","","G4String");
     }
     return store;
@@ -142,6 +156,8 @@ std::vector<G4AttValue>* PhotonDetHit::CreateAttValues() const
 
     values->push_back(G4AttValue("SiPMNo", fSiPMNo,""));
 
+    values->push_back(G4AttValue("SiPMHits", G4UIcommand::ConvertToString(fSiPMHits),""));
+
     if (fLogicalVolume)
     values->push_back(G4AttValue("LVol",fLogicalVolume->GetName(),""));
     else
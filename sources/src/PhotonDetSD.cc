@@ -16,7 +16,8 @@
 PhotonDetSD::PhotonDetSD(G4String name, G4int verbose)
 : G4VSensitiveDetector(name),
 fPhotonDetHitCollection(0),
-fVerbose(verbose)
+fVerbose(verbose),
+fExpectedHits(0)
 {
     collectionName.insert("PhotonDetHitCollection");
 }
@@ -30,6 +31,9 @@ PhotonDetSD::~PhotonDetSD() { }
 void PhotonDetSD::Initialize(G4HCofThisEvent* HCE)
 {
     fPhotonDetHitCollection = new PhotonDetHitsCollection(SensitiveDetectorName, collectionName[0]);
+    //The collection is owned by the event, only its size is carried over to
+    //avoid growing the vector of hits again in each event
+    fPhotonDetHitCollection->GetVector()->reserve(fExpectedHits);
     //Store collection with event and keep ID
     static G4int HCID = -1;
     if (HCID<0) HCID = GetCollectionID(0);
@@ -86,6 +90,8 @@ G4bool PhotonDetSD::ProcessHits_constStep(const G4Step* aStep, G4TouchableHistor
 
 void PhotonDetSD::EndOfEvent(G4HCofThisEvent*)
 {
+    fExpectedHits = fPhotonDetHitCollection->entries();
+
     if(fVerbose > 1)
     {
         G4int nDetected = fPhotonDetHitCollection->entries();
@@ -20,6 +20,7 @@
 #include "G4OpBoundaryProcess.hh"
 
 #include "G4LossTableManager.hh"
+#include "G4EmParameters.hh"
 #include "G4EmSaturation.hh"
 
 #include "G4Decay.hh"
@@ -37,7 +38,35 @@
 #include "G4MuPairProduction.hh"
 #include "G4hIonisation.hh"
 
+#include "G4EmStandardPhysics.hh"
+#include "G4EmStandardPhysics_option1.hh"
+#include "G4EmStandardPhysics_option3.hh"
+#include "G4EmStandardPhysics_option4.hh"
+#include "G4EmLivermorePhysics.hh"
+#include "G4EmPenelopePhysics.hh"
+
 #include "G4Threading.hh"
+#include "G4Version.hh"
+
+#include "G4Material.hh"
+#include "G4Element.hh"
+#include "G4ProductionCuts.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4ProcessVector.hh"
+#include "G4UnitsTable.hh"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
@@ -45,17 +74,61 @@
 #include "StepMax.hh"
 #include "G4UserSpecialCuts.hh"
 #include "G4StepLimiter.hh"
+#include "G4FastSimulationManagerProcess.hh"
 
 G4ThreadLocal G4int PhysicsList::fVerboseLevel = 1;
 G4ThreadLocal G4Scintillation* PhysicsList::fScintillationProcess = 0;
 G4ThreadLocal G4OpAbsorption* PhysicsList::fAbsorptionProcess = 0;
 G4ThreadLocal G4OpRayleigh* PhysicsList::fRayleighScatteringProcess = 0;
 G4ThreadLocal G4OpBoundaryProcess* PhysicsList::fBoundaryProcess = 0;
+G4ThreadLocal G4VPhysicsConstructor* PhysicsList::fEmPhysics = 0;
+
+namespace {
+    // Name of the file holding the configuration of a cached table directory,
+    // written once all the tables are stored.
+    const char* kTableCacheKeyFile = "d2tb_tables.key";
+
+    // Create a directory and its parents.
+    G4bool MakeDirectories(const G4String& path)
+    {
+        for (std::size_t i = 1; i <= path.size(); i++) {
+            if (i < path.size() && path[i] != '/') continue;
+            G4String parent = path.substr(0, i);
+            if (mkdir(parent.c_str(), 0755) != 0 && errno != EEXIST) return false;
+        }
+        return true;
+    }
+
+    // Remove a directory and the files in it.
+    void RemoveDirectory(const G4String& path)
+    {
+        if (DIR* dir = opendir(path.c_str())) {
+            while (struct dirent* entry = readdir(dir)) {
+                G4String name = entry->d_name;
+                if (name == "." || name == "..") continue;
+                std::remove((path + "/" + name).c_str());
+            }
+            closedir(dir);
+        }
+        rmdir(path.c_str());
+    }
+
+    G4String ReadFile(const G4String& filename)
+    {
+        std::ifstream in(filename.c_str());
+        std::ostringstream content;
+        content << in.rdbuf();
+        return content.str();
+    }
+}
 
 PhysicsList::PhysicsList()
-: G4VUserPhysicsList()
+: G4VUserPhysicsList(),
+fStoreTableCache(false)
 {
     fDefaultCutValue = 0.7*mm;
+    fEmOption = "local";
+    if (const char* env = std::getenv("D2TB_PHYSICS_CACHE")) fTableCache = env;
     fMessenger = new PhysicsListMessenger(this);
     fStepMaxProcess = new StepMax();
 }
@@ -63,6 +136,17 @@ PhysicsList::PhysicsList()
 PhysicsList::~PhysicsList()
 {
     delete fMessenger;
+    delete fEmPhysics;
+    fEmPhysics = nullptr;
+}
+
+void PhysicsList::TerminateWorker()
+{
+    // The destructor only runs on the master, each worker has its own
+    // constructor
+    delete fEmPhysics;
+    fEmPhysics = nullptr;
+    G4VUserPhysicsList::TerminateWorker();
 }
 
 void PhysicsList::ConstructParticle()
@@ -98,6 +182,8 @@ void PhysicsList::ConstructProcess()
     ConstructEM();
     G4cout << "PhysicsList::ConstructProcess() : ConstructOp()" << G4endl;
     ConstructOp();
+    G4cout << "PhysicsList::ConstructProcess() : AddParameterisation()" << G4endl;
+    AddParameterisation();
     G4cout << "PhysicsList::ConstructProcess() : AddStepMax()" << G4endl;
     AddStepMax();
     G4cout << "PhysicsList::ConstructProcess() : AddLimiters()" << G4endl;
@@ -124,6 +210,21 @@ void PhysicsList::ConstructDecay()
 
 void PhysicsList::ConstructEM()
 {
+    // The Geant4 constructors register their processes for all the particles,
+    // they are kept for the life of the thread like the processes.
+    if (fEmOption != "local") {
+        if (fEmOption == "opt1") fEmPhysics = new G4EmStandardPhysics_option1();
+        else if (fEmOption == "opt3") fEmPhysics = new G4EmStandardPhysics_option3();
+        else if (fEmOption == "opt4") fEmPhysics = new G4EmStandardPhysics_option4();
+        else if (fEmOption == "livermore") fEmPhysics = new G4EmLivermorePhysics();
+        else if (fEmOption == "penelope") fEmPhysics = new G4EmPenelopePhysics();
+        else fEmPhysics = new G4EmStandardPhysics();
+
+        G4cout << "PhysicsList::ConstructEM() : " << fEmPhysics->GetPhysicsName() << G4endl;
+        fEmPhysics->ConstructProcess();
+        return;
+    }
+
     auto particleIterator=GetParticleIterator();
     particleIterator->reset();
     while( (*particleIterator)() ){
@@ -237,6 +338,17 @@ void PhysicsList::AddStepMax()
     }
 }
 
+void PhysicsList::AddParameterisation()
+{
+    // The showers of the electrons and positrons can be parameterised in the
+    // crystals (see /d2tb/det/showerParameterisation), the process does
+    // nothing in the volumes without a model.
+    G4FastSimulationManagerProcess* fastSimProcess = new G4FastSimulationManagerProcess("FastSimulation");
+
+    G4Electron::Electron()->GetProcessManager()->AddDiscreteProcess(fastSimProcess);
+    G4Positron::Positron()->GetProcessManager()->AddDiscreteProcess(fastSimProcess);
+}
+
 void PhysicsList::SetVerbose(G4int verbose)
 {
     fVerboseLevel = verbose;
@@ -252,6 +364,16 @@ void PhysicsList::SetStepMax(G4double val)
     fStepMaxProcess->SetStepMax(val);
 }
 
+void PhysicsList::SetRegionStepMax(const G4String& region, G4double val)
+{
+    fStepMaxProcess->SetStepMax(region, val);
+}
+
+void PhysicsList::SetStepMaxRangeFraction(const G4String& region, G4double fraction)
+{
+    fStepMaxProcess->SetRangeFraction(region, fraction);
+}
+
 void PhysicsList::SetCuts()
 {
     if(verboseLevel > 0){
@@ -267,7 +389,141 @@ void PhysicsList::SetCuts()
     SetCutValue(fDefaultCutValue, "proton");
     SetCutValue(fDefaultCutValue, "e+");
 
+    ApplyRegionCuts();
+
     if (verboseLevel > 0) DumpCutValuesTable();
+
+    // The materials and the processes are known at this point, the tables
+    // are built (or retrieved) at the start of the first run.
+    fStoreTableCache = false;
+    if (fTableCache.empty() || !G4Threading::IsMasterThread()) return;
+
+    fTableCacheKey = GetTableCacheKey();
+
+    // FNV-1a hash of the configuration
+    unsigned long long hash = 14695981039346656037ULL;
+    for (unsigned char c : fTableCacheKey) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << hash;
+    fTableCachePath = fTableCache + "/" + name.str();
+
+    if (ReadFile(fTableCachePath + "/" + kTableCacheKeyFile) == fTableCacheKey) {
+        G4cout << "PhysicsList::SetCuts() : Retrieve the physics tables from " << fTableCachePath << G4endl;
+        SetPhysicsTableRetrieved(fTableCachePath);
+    }
+    else {
+        G4cout << "PhysicsList::SetCuts() : The physics tables will be stored in " << fTableCachePath << G4endl;
+        fStoreTableCache = true;
+    }
+}
+
+void PhysicsList::SetRegionCut(const G4String& region, G4double cut)
+{
+    fRegionCuts[region] = cut;
+    ApplyRegionCuts();
+}
+
+void PhysicsList::ApplyRegionCuts()
+{
+    // The regions are created with the geometry, before the cuts are set
+    for (const auto& regionCut : fRegionCuts) {
+        G4Region* region = G4RegionStore::GetInstance()->GetRegion(regionCut.first, false);
+        if (!region) continue;
+
+        SetParticleCuts(regionCut.second, "gamma", region);
+        SetParticleCuts(regionCut.second, "e-", region);
+        SetParticleCuts(regionCut.second, "e+", region);
+        SetParticleCuts(regionCut.second, "proton", region);
+
+        if (verboseLevel > 0) {
+            G4cout << "PhysicsList::ApplyRegionCuts() : Cut of " << region->GetName()
+            << " : " << G4BestUnit(regionCut.second, "Length") << G4endl;
+        }
+    }
+}
+
+G4String PhysicsList::GetTableCacheKey() const
+{
+    std::ostringstream key;
+    key << std::setprecision(10);
+    key << "geant4 " << G4VERSION_NUMBER << "\n";
+
+    // The EM options register processes of the same names with different
+    // models, the option and its parameters tell their tables apart
+    key << "em " << fEmOption << "\n";
+    key << *G4EmParameters::Instance() << "\n";
+
+    // Production cuts and their energy range
+    auto cutsTable = G4ProductionCutsTable::GetProductionCutsTable();
+    key << "energyRange " << cutsTable->GetLowEdgeEnergy() << " " << cutsTable->GetHighEdgeEnergy() << "\n";
+    for (auto region : *G4RegionStore::GetInstance()) {
+        G4ProductionCuts* cuts = region->GetProductionCuts();
+        key << "region " << region->GetName();
+        if (cuts) {
+            for (G4int i = 0; i < NumberOfG4CutIndex; i++) key << " " << cuts->GetProductionCut(i);
+        }
+        key << "\n";
+    }
+
+    // Materials
+    for (auto material : *G4Material::GetMaterialTable()) {
+        key << "material " << material->GetName() << " " << material->GetDensity()
+        << " " << material->GetState() << " " << material->GetTemperature()
+        << " " << material->GetPressure()
+        << " " << material->GetIonisation()->GetMeanExcitationEnergy()
+        << " " << material->GetIonisation()->GetBirksConstant();
+        for (std::size_t i = 0; i < material->GetNumberOfElements(); i++) {
+            const G4Element* element = material->GetElement(i);
+            key << " " << element->GetZ() << ":" << element->GetN() << ":" << material->GetFractionVector()[i];
+        }
+        key << "\n";
+    }
+
+    // Processes of each particle
+    auto particleIterator=GetParticleIterator();
+    particleIterator->reset();
+    while( (*particleIterator)() ){
+        G4ParticleDefinition* particle = particleIterator->value();
+        G4ProcessManager* pmanager = particle->GetProcessManager();
+        if (!pmanager) continue;
+        G4ProcessVector* processes = pmanager->GetProcessList();
+        key << "particle " << particle->GetParticleName();
+        for (G4int i = 0; i < G4int(processes->size()); i++) key << " " << (*processes)[i]->GetProcessName();
+        key << "\n";
+    }
+
+    return key.str();
+}
+
+void PhysicsList::StoreTableCache()
+{
+    if (!fStoreTableCache) return;
+    fStoreTableCache = false;
+
+    // The tables are written in a temporary directory which is renamed once
+    // complete, so that jobs sharing the cache never read partial tables.
+    std::ostringstream temporary;
+    temporary << fTableCachePath << ".tmp" << getpid();
+    if (!MakeDirectories(temporary.str()) || !StorePhysicsTable(temporary.str())) {
+        G4cout << "PhysicsList::StoreTableCache() : Cannot store the physics tables in " << temporary.str() << G4endl;
+        RemoveDirectory(temporary.str());
+        return;
+    }
+
+    std::ofstream out((temporary.str() + "/" + kTableCacheKeyFile).c_str());
+    out << fTableCacheKey;
+    out.close();
+
+    // Another job may have stored the same tables in the meantime
+    if (!out || std::rename(temporary.str().c_str(), fTableCachePath.c_str()) != 0) {
+        RemoveDirectory(temporary.str());
+        return;
+    }
+
+    G4cout << "PhysicsList::StoreTableCache() : Physics tables stored in " << fTableCachePath << G4endl;
 }
 
 void PhysicsList::AddLimiters()
@@ -288,7 +544,9 @@ void PhysicsList::AddLimiters()
             FatalException,o.str().c_str());
         }
 
-        if (particleName == "opticalphoton") break;
+        // The table is iterated in alphabetical order, the particles after
+        // the optical photon need their limiters as well
+        if (particleName == "opticalphoton") continue;
 
         if (charge != 0.0) {
             // All charged particles should have a step limiter
@@ -4,13 +4,33 @@
 #include <G4UIdirectory.hh>
 #include "G4UIcmdWithAnInteger.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+namespace {
+    // The regions of the detector construction
+    G4String GetRegionName(const G4String& name)
+    {
+        if (name == "crystal") return "CrystalRegion";
+        if (name == "sipm") return "SiPMRegion";
+        return "DefaultRegionForTheWorld";
+    }
+}
 
 PhysicsListMessenger::PhysicsListMessenger(PhysicsList* pPhys)
 : G4UImessenger(),
 fPhysicsList(pPhys),
 fDirectory(0),
 fVerboseCmd(0),
-fStepMaxSizeCmd(0)
+fStepMaxSizeCmd(0),
+fTableCacheCmd(0),
+fEmCmd(0),
+fRegionCutCmd(0),
+fRegionStepMaxCmd(0),
+fRangeFractionCmd(0)
 {
     fDirectory = new G4UIdirectory("/d2tb/phys/");
     fDirectory->SetGuidance("Control the physics lists");
@@ -29,12 +49,84 @@ fStepMaxSizeCmd(0)
     fStepMaxSizeCmd->SetRange("StepMaxSize>=0");
     fStepMaxSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
 
+    fTableCacheCmd = new G4UIcmdWithAString("/d2tb/phys/tableCache",this);
+    fTableCacheCmd->SetGuidance("Store and retrieve the physics tables in a cache directory.");
+    fTableCacheCmd->SetGuidance("The tables of each configuration of the materials, cuts and processes");
+    fTableCacheCmd->SetGuidance("are built once. Set before /run/initialize, \"none\" disables the cache.");
+    fTableCacheCmd->SetParameterName("directory",false);
+    fTableCacheCmd->AvailableForStates(G4State_PreInit);
+    fTableCacheCmd->SetToBeBroadcasted(false);
+
+    fEmCmd = new G4UIcmdWithAString("/d2tb/phys/em",this);
+    fEmCmd->SetGuidance("Select the EM physics, before /run/initialize.");
+    fEmCmd->SetGuidance("  local     : the minimal set of processes of this list (default)");
+    fEmCmd->SetGuidance("  opt0      : G4EmStandardPhysics");
+    fEmCmd->SetGuidance("  opt1      : G4EmStandardPhysics_option1, the fastest");
+    fEmCmd->SetGuidance("  opt3, opt4: the precise standard options");
+    fEmCmd->SetGuidance("  livermore, penelope : the low energy models");
+    fEmCmd->SetGuidance("The optical processes are the same with all of them.");
+    fEmCmd->SetParameterName("option",false);
+    fEmCmd->SetCandidates("local opt0 opt1 opt3 opt4 livermore penelope");
+    fEmCmd->AvailableForStates(G4State_PreInit);
+    fEmCmd->SetToBeBroadcasted(false);
+
+    fRegionCutCmd = new G4UIcommand("/d2tb/phys/regionCut",this);
+    fRegionCutCmd->SetGuidance("Set the production cut of a region (gamma, e-, e+ and proton).");
+    fRegionCutCmd->SetGuidance("  crystal : the crystals and their holes");
+    fRegionCutCmd->SetGuidance("  sipm    : the SiPMs");
+    fRegionCutCmd->SetGuidance("  world   : the world, and the regions without their own cut");
+    auto regionPrm = new G4UIparameter("region",'s',false);
+    regionPrm->SetParameterCandidates("crystal sipm world");
+    fRegionCutCmd->SetParameter(regionPrm);
+    auto cutPrm = new G4UIparameter("cut",'d',false);
+    cutPrm->SetParameterRange("cut>0");
+    fRegionCutCmd->SetParameter(cutPrm);
+    auto unitPrm = new G4UIparameter("unit",'s',true);
+    unitPrm->SetDefaultValue("mm");
+    unitPrm->SetParameterCandidates(G4UIcommand::UnitsList("Length"));
+    fRegionCutCmd->SetParameter(unitPrm);
+    fRegionCutCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fRegionCutCmd->SetToBeBroadcasted(false);
+
+    fRegionStepMaxCmd = new G4UIcommand("/d2tb/phys/regionStepMax",this);
+    fRegionStepMaxCmd->SetGuidance("Set the max step size of the charged particles in a region (crystal, sipm or world).");
+    fRegionStepMaxCmd->SetGuidance("It replaces StepMaxSize in this region, 0 for no limit.");
+    regionPrm = new G4UIparameter("region",'s',false);
+    regionPrm->SetParameterCandidates("crystal sipm world");
+    fRegionStepMaxCmd->SetParameter(regionPrm);
+    auto stepPrm = new G4UIparameter("step",'d',false);
+    stepPrm->SetParameterRange("step>=0");
+    fRegionStepMaxCmd->SetParameter(stepPrm);
+    unitPrm = new G4UIparameter("unit",'s',true);
+    unitPrm->SetDefaultValue("mm");
+    unitPrm->SetParameterCandidates(G4UIcommand::UnitsList("Length"));
+    fRegionStepMaxCmd->SetParameter(unitPrm);
+    fRegionStepMaxCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fRegionStepMaxCmd->SetToBeBroadcasted(false);
+
+    fRangeFractionCmd = new G4UIcommand("/d2tb/phys/StepMaxRangeFraction",this);
+    fRangeFractionCmd->SetGuidance("Limit the steps of the charged particles in a region (crystal, sipm or world)");
+    fRangeFractionCmd->SetGuidance("to a fraction of their range, but not below the max step size of the region.");
+    fRangeFractionCmd->SetGuidance("Set the fraction to zero to only use the max step size.");
+    regionPrm = new G4UIparameter("region",'s',false);
+    regionPrm->SetParameterCandidates("crystal sipm world");
+    fRangeFractionCmd->SetParameter(regionPrm);
+    auto fractionPrm = new G4UIparameter("fraction",'d',false);
+    fractionPrm->SetParameterRange("fraction>=0 && fraction<=1");
+    fRangeFractionCmd->SetParameter(fractionPrm);
+    fRangeFractionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fRangeFractionCmd->SetToBeBroadcasted(false);
 }
 
 PhysicsListMessenger::~PhysicsListMessenger()
 {
     delete fVerboseCmd;
     delete fStepMaxSizeCmd;
+    delete fTableCacheCmd;
+    delete fEmCmd;
+    delete fRegionCutCmd;
+    delete fRegionStepMaxCmd;
+    delete fRangeFractionCmd;
 }
 
 void PhysicsListMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
@@ -47,4 +139,39 @@ void PhysicsListMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
     {
         fPhysicsList->SetStepMax(fStepMaxSizeCmd->GetNewDoubleValue(newValue));
     }
+    else if( command == fTableCacheCmd )
+    {
+        fPhysicsList->SetTableCache(newValue == "none" ? G4String() : newValue);
+    }
+    else if( command == fEmCmd )
+    {
+        fPhysicsList->SetEmOption(newValue);
+    }
+    else if( command == fRegionCutCmd )
+    {
+        std::istringstream is(newValue);
+        G4String region, unit;
+        G4double cut;
+        is >> region >> cut >> unit;
+
+        fPhysicsList->SetRegionCut(GetRegionName(region), cut*G4UIcommand::ValueOf(unit));
+    }
+    else if( command == fRegionStepMaxCmd )
+    {
+        std::istringstream is(newValue);
+        G4String region, unit;
+        G4double step;
+        is >> region >> step >> unit;
+
+        fPhysicsList->SetRegionStepMax(GetRegionName(region), step*G4UIcommand::ValueOf(unit));
+    }
+    else if( command == fRangeFractionCmd )
+    {
+        std::istringstream is(newValue);
+        G4String region;
+        G4double fraction;
+        is >> region >> fraction;
+
+        fPhysicsList->SetStepMaxRangeFraction(GetRegionName(region), fraction);
+    }
 }
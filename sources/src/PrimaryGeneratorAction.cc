@@ -1,4 +1,7 @@
 #include "PrimaryGeneratorAction.hh"
+#include "SeedManager.hh"
+#include "GenstepManager.hh"
+#include "Logger.hh"
 
 #include "G4Event.hh"
 #include "G4ParticleGun.hh"
@@ -38,8 +41,34 @@ PrimaryGeneratorAction::~PrimaryGeneratorAction()
 void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
     // This function is called at the begining of event
+    SeedManager::SeedEvent(anEvent);
+
+    GenstepManager::Clear();
+    if (GenstepManager::GetMode() == GenstepManager::kReplay) {
+        GeneratePhotons(anEvent);
+        return;
+    }
+
     fG4ParticleGun->GeneratePrimaryVertex(anEvent);
     // fGPSParticleGun->GeneratePrimaryVertex(anEvent);
+
+    // The photons of the shower are generated once it is done
+    if (GenstepManager::IsLazy()) GenstepManager::AddMarker(anEvent);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction::GeneratePhotons(G4Event* anEvent)
+{
+    G4int eventId = SeedManager::GetEventId(anEvent);
+    if (!GenstepManager::ReadEvent(eventId)) {
+        D2TB_LOG_LIMITED(kWarning, "PrimaryGeneratorAction::GeneratePhotons") << "PrimaryGeneratorAction::GeneratePhotons() : Event "
+        << eventId << " is not in the replayed input (/d2tb/genstep/input)";
+        return;
+    }
+
+    // The stacking action generates the photons once the event starts
+    GenstepManager::AddMarker(anEvent);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
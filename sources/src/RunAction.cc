@@ -5,12 +5,14 @@
 
 #include "D2TBRun.hh"
 #include "RunAction.hh"
+#include "Logger.hh"
+#include "SeedManager.hh"
+#include "DetectorConstruction.hh"
+#include "PhysicsList.hh"
 
 #include "G4Run.hh"
 #include "G4RunManager.hh"
 
-#include <ctime>
-
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 RunAction::RunAction()
@@ -38,19 +40,27 @@ G4Run* RunAction::GenerateRun()
 
 void RunAction::BeginOfRunAction(const G4Run* aRun)
 {
-    //to be sure to generate different events!
-    G4cout << "*******************" << G4endl;
-    G4cout << "*** AUTOSEED ON ***" << G4endl;
-    G4cout << "*******************" << G4endl;
-
-    long seeds[2];
-    long systime = time(NULL);
-    seeds[0] = systime;
-    seeds[1] = systime * G4UniformRand();
-    G4Random::setTheSeeds(seeds);
-    G4Random::showEngineStatus();
-
-    G4cout << "### Run " << aRun->GetRunID() << " start." << G4endl;
+    Logger::BeginOfRun();
+
+    // The events are seeded from the master seed and their ids
+    if (isMaster) SeedManager::BeginOfRun();
+
+    // The physics tables are built, store them in the cache if needed
+    if (isMaster) {
+        auto physicsList = dynamic_cast<const PhysicsList*>(G4RunManager::GetRunManager()->GetUserPhysicsList());
+        if (physicsList) const_cast<PhysicsList*>(physicsList)->StoreTableCache();
+    }
+
+    // The geometry parameters are only applied by /d2tb/det/update
+    if (isMaster) {
+        auto detector = dynamic_cast<const DetectorConstruction*>(G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+        if (detector && detector->IsModified()) {
+            D2TB_LOG(kWarning) << "Geometry parameters changed without /d2tb/det/update, they are not used by this run";
+        }
+    }
+
+    D2TB_LOG(kInfo) << "### Run " << aRun->GetRunID() << " start.";
+    Logger::Flush();
     fTimer->Start();
 }
 
@@ -61,7 +71,8 @@ void RunAction::EndOfRunAction(const G4Run* aRun)
     if (isMaster) fRun->EndOfRun();
     
     fTimer->Stop();
-    G4cout << "Number of event = " << aRun->GetNumberOfEvent() << " " << *fTimer << G4endl;
+    D2TB_LOG(kInfo) << "Number of event = " << aRun->GetNumberOfEvent() << " " << *fTimer;
+    Logger::EndOfRun();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
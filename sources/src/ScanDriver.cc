@@ -0,0 +1,208 @@
+#include "ScanDriver.hh"
+#include "ScanMessenger.hh"
+#include "DetectorConstruction.hh"
+#include "D2TBRun.hh"
+#include "TG4RunSummary.hh"
+
+#include "G4RunManager.hh"
+#include "G4UnitsTable.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+    const char* kParameterNames[] = { "ncrystal", "crystalSizeXY", "crystalDepth",
+        "sipmSizeXY", "sipmDepth", "pde" };
+    const char* kUnitCategories[] = { "", "Length", "Length", "Length", "Length", "" };
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScanDriver::ScanDriver(DetectorConstruction* detector)
+: fDetector(detector),
+fMessenger(nullptr),
+fEventsPerPoint(100),
+fFilename("scan.csv")
+{
+    fMessenger = new ScanMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScanDriver::~ScanDriver()
+{
+    delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String ScanDriver::GetParameterName(G4int parameter)
+{
+    if (parameter < 0 || parameter >= kNParameters) return "";
+    return kParameterNames[parameter];
+}
+
+G4String ScanDriver::GetUnitCategory(G4int parameter)
+{
+    if (parameter < 0 || parameter >= kNParameters) return "";
+    return kUnitCategories[parameter];
+}
+
+G4int ScanDriver::GetParameterFromName(const G4String& name)
+{
+    for (G4int parameter = 0; parameter < kNParameters; parameter++) {
+        if (name == kParameterNames[parameter]) return parameter;
+    }
+    return -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ScanDriver::AddParameter(const G4String& name, const std::vector<G4double>& values)
+{
+    G4int parameter = GetParameterFromName(name);
+    if (parameter < 0 || values.empty()) {
+        G4ExceptionDescription msg;
+        msg << "Unknown scan parameter or no values: " << name;
+        G4Exception("ScanDriver::AddParameter()", "Scan0001", JustWarning, msg);
+        return false;
+    }
+
+    for (auto value : values) {
+        G4bool valid = value > 0;
+        if (parameter == kNCrystal) valid = value >= 1 && value <= 9 && value == std::floor(value);
+        if (parameter == kSiPM_PDE) valid = value >= 0 && value <= 1;
+        if (!valid) {
+            G4ExceptionDescription msg;
+            msg << "Invalid value " << value << " of the scan parameter " << name;
+            G4Exception("ScanDriver::AddParameter()", "Scan0002", JustWarning, msg);
+            return false;
+        }
+    }
+
+    fGrid[parameter] = values;
+
+    return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ScanDriver::GetNumberOfPoints() const
+{
+    if (fGrid.empty()) return 0;
+
+    G4int points = 1;
+    for (const auto& parameter : fGrid) points *= parameter.second.size();
+    return points;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ScanDriver::GetValue(G4int parameter) const
+{
+    switch (parameter) {
+        case kNCrystal:      return fDetector->GetNCrystal();
+        case kCrystalSizeXY: return fDetector->GetCrystalSizeXY();
+        case kCrystalDepth:  return fDetector->GetCrystalDepth();
+        case kSiPMSizeXY:    return fDetector->GetSiPMSizeXY();
+        case kSiPMDepth:     return fDetector->GetSiPMDepth();
+        case kSiPM_PDE:      return fDetector->GetSiPM_PDE();
+    }
+    return 0;
+}
+
+void ScanDriver::SetValue(G4int parameter, G4double value)
+{
+    switch (parameter) {
+        case kNCrystal:      fDetector->SetNCrystal(G4int(value)); break;
+        case kCrystalSizeXY: fDetector->SetCrystalSizeXY(value); break;
+        case kCrystalDepth:  fDetector->SetCrystalDepth(value); break;
+        case kSiPMSizeXY:    fDetector->SetSiPMSizeXY(value); break;
+        case kSiPMDepth:     fDetector->SetSiPMDepth(value); break;
+        case kSiPM_PDE:      fDetector->SetSiPM_PDE(value); break;
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScanDriver::Run()
+{
+    G4int nPoints = GetNumberOfPoints();
+    if (nPoints == 0 || fEventsPerPoint <= 0) {
+        G4cout << "ScanDriver::Run -- Nothing to scan (" << nPoints << " points, "
+        << fEventsPerPoint << " events per point)" << G4endl;
+        return;
+    }
+
+    std::ofstream out(fFilename.c_str());
+    if (!out) {
+        G4ExceptionDescription msg;
+        msg << "Cannot write the scan results in " << fFilename;
+        G4Exception("ScanDriver::Run()", "Scan0003", FatalException, msg);
+        return;
+    }
+
+    // Lengths are written in mm
+    out << "point,run";
+    for (G4int parameter = 0; parameter < kNParameters; parameter++) {
+        out << "," << kParameterNames[parameter];
+        if (GetUnitCategory(parameter) == "Length") out << "_mm";
+    }
+    out << ",events,detectedMean,detectedSigma,resolution,detectedPhotons,scintPhotons,absorbed,boundaryAbsorbed" << "\n";
+    out << std::setprecision(10);
+
+    G4RunManager* runManager = G4RunManager::GetRunManager();
+
+    // The grid is walked as an odometer, the last parameter moving the fastest
+    std::map<G4int, std::size_t> index;
+    for (const auto& parameter : fGrid) index[parameter.first] = 0;
+
+    for (G4int point = 0; point < nPoints; point++) {
+        G4cout << "ScanDriver -- Point " << point+1 << " of " << nPoints << " :";
+        for (const auto& parameter : fGrid) {
+            G4double value = parameter.second[index[parameter.first]];
+            G4cout << " " << kParameterNames[parameter.first] << "=";
+            if (GetUnitCategory(parameter.first).size()) G4cout << G4BestUnit(value, GetUnitCategory(parameter.first));
+            else G4cout << value;
+
+            if (value != GetValue(parameter.first)) SetValue(parameter.first, value);
+        }
+        G4cout << G4endl;
+
+        // Only the volumes affected by the parameters which changed are
+        // modified.
+        fDetector->UpdateGeometry();
+
+        runManager->BeamOn(fEventsPerPoint);
+
+        const D2TBRun* run = dynamic_cast<const D2TBRun*>(runManager->GetCurrentRun());
+        if (!run) break;
+
+        TG4RunSummary summary;
+        run->FillSummary(summary);
+
+        out << point << "," << run->GetRunID();
+        for (G4int parameter = 0; parameter < kNParameters; parameter++) {
+            G4double value = GetValue(parameter);
+            if (GetUnitCategory(parameter) == "Length") value /= mm;
+            out << "," << value;
+        }
+        out << "," << summary.Events << "," << summary.DetectedMean
+        << "," << summary.GetDetectedSigma() << "," << summary.GetResolution()
+        << "," << summary.DetectedPhotons << "," << summary.ScintPhotons
+        << "," << summary.Absorbed << "," << summary.BoundaryAbsorbed << "\n";
+
+        // Keep the points already done if the job is stopped
+        out.flush();
+
+        for (auto parameter = fGrid.rbegin(); parameter != fGrid.rend(); ++parameter) {
+            if (++index[parameter->first] < parameter->second.size()) break;
+            index[parameter->first] = 0;
+        }
+    }
+
+    G4cout << "ScanDriver -- " << nPoints << " points written in " << fFilename << G4endl;
+}
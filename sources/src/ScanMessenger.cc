@@ -0,0 +1,135 @@
+#include "ScanMessenger.hh"
+#include "ScanDriver.hh"
+
+#include <G4UIdirectory.hh>
+#include <G4UIcommand.hh>
+#include <G4UIcmdWithAString.hh>
+#include <G4UIcmdWithAnInteger.hh>
+#include <G4UIcmdWithoutParameter.hh>
+#include <G4UnitsTable.hh>
+
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+namespace {
+    G4bool IsNumber(const G4String& token)
+    {
+        char* end = nullptr;
+        std::strtod(token.c_str(), &end);
+        return end != token.c_str() && *end == '\0';
+    }
+}
+
+ScanMessenger::ScanMessenger(ScanDriver* scanDriver)
+: fScanDriver(scanDriver)
+{
+    fScanDIR = new G4UIdirectory("/d2tb/scan/");
+    fScanDIR->SetGuidance("Scan of the detector parameters in one process.");
+
+    fAddCMD = new G4UIcmdWithAString("/d2tb/scan/add", this);
+    fAddCMD->SetGuidance("Add a parameter to the grid: <parameter> <value> [<value> ...] [unit]");
+    fAddCMD->SetGuidance("The parameters are ncrystal, crystalSizeXY, crystalDepth, sipmSizeXY,");
+    fAddCMD->SetGuidance("sipmDepth (with a length unit, mm by default) and pde (0 to 1).");
+    fAddCMD->SetParameterName("values", false);
+    fAddCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fAddCMD->SetToBeBroadcasted(false);
+
+    fClearCMD = new G4UIcmdWithoutParameter("/d2tb/scan/clear", this);
+    fClearCMD->SetGuidance("Remove all the parameters of the grid.");
+    fClearCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fClearCMD->SetToBeBroadcasted(false);
+
+    fEventsCMD = new G4UIcmdWithAnInteger("/d2tb/scan/events", this);
+    fEventsCMD->SetGuidance("Set the number of events run at each point of the grid.");
+    fEventsCMD->SetParameterName("events", false);
+    fEventsCMD->SetRange("events>0");
+    fEventsCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fEventsCMD->SetToBeBroadcasted(false);
+
+    fOutputCMD = new G4UIcmdWithAString("/d2tb/scan/output", this);
+    fOutputCMD->SetGuidance("Set the CSV file of the results (one line per point).");
+    fOutputCMD->SetParameterName("filename", false);
+    fOutputCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fOutputCMD->SetToBeBroadcasted(false);
+
+    fRunCMD = new G4UIcmdWithoutParameter("/d2tb/scan/run", this);
+    fRunCMD->SetGuidance("Run all the points of the grid.");
+    fRunCMD->AvailableForStates(G4State_Idle);
+    fRunCMD->SetToBeBroadcasted(false);
+}
+
+ScanMessenger::~ScanMessenger()
+{
+    delete fAddCMD;
+    delete fClearCMD;
+    delete fEventsCMD;
+    delete fOutputCMD;
+    delete fRunCMD;
+    delete fScanDIR;
+}
+
+void ScanMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fAddCMD) {
+        std::istringstream is(newValue);
+        G4String name;
+        is >> name;
+
+        std::vector<G4String> tokens;
+        G4String token;
+        while (is >> token) tokens.push_back(token);
+
+        // A trailing word is the unit of the values
+        G4int parameter = ScanDriver::GetParameterFromName(name);
+        G4double unit = 1.;
+        G4String category = ScanDriver::GetUnitCategory(parameter);
+        if (category.size()) unit = G4UIcommand::ValueOf("mm");
+        if (!tokens.empty() && !IsNumber(tokens.back())) {
+            if (category.empty() || !G4UnitDefinition::IsUnitDefined(tokens.back())
+                || G4UnitDefinition::GetCategory(tokens.back()) != category) {
+                G4cout << "ScanMessenger -- Invalid unit " << tokens.back() << " for " << name << G4endl;
+                return;
+            }
+            unit = G4UIcommand::ValueOf(tokens.back());
+            tokens.pop_back();
+        }
+
+        std::vector<G4double> values;
+        for (const auto& value : tokens) {
+            if (!IsNumber(value)) {
+                G4cout << "ScanMessenger -- Invalid value " << value << " for " << name << G4endl;
+                return;
+            }
+            values.push_back(G4UIcommand::ConvertToDouble(value)*unit);
+        }
+
+        fScanDriver->AddParameter(name, values);
+    }
+    else if (command == fClearCMD) {
+        fScanDriver->Clear();
+    }
+    else if (command == fEventsCMD) {
+        fScanDriver->SetEventsPerPoint(fEventsCMD->GetNewIntValue(newValue));
+    }
+    else if (command == fOutputCMD) {
+        fScanDriver->SetFilename(newValue);
+    }
+    else if (command == fRunCMD) {
+        fScanDriver->Run();
+    }
+}
+
+G4String ScanMessenger::GetCurrentValue(G4UIcommand * command)
+{
+    G4String currentValue;
+
+    if (command == fEventsCMD) {
+        currentValue = G4UIcommand::ConvertToString(fScanDriver->GetEventsPerPoint());
+    }
+    else if (command == fOutputCMD) {
+        currentValue = fScanDriver->GetFilename();
+    }
+
+    return currentValue;
+}
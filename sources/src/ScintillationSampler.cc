@@ -0,0 +1,124 @@
+#include "ScintillationSampler.hh"
+#include "Genstep.hh"
+
+#include "G4Material.hh"
+#include "G4MaterialPropertiesTable.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Poisson.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScintillationSampler::ScintillationSampler() { }
+
+ScintillationSampler::~ScintillationSampler() { }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const ScintillationSampler::Emission* ScintillationSampler::GetEmission(const G4Material* material)
+{
+    if (!material) return nullptr;
+
+    auto cached = fEmissions.find(material);
+    if (cached != fEmissions.end()) {
+        if (cached->second.fIntegral.empty()) return nullptr;
+        return &cached->second;
+    }
+
+    // A material which does not scintillate is cached without spectrum
+    Emission& emission = fEmissions[material];
+    emission.fYield = 0.;
+    emission.fResolutionScale = 1.;
+    emission.fDecayTime = 0.;
+
+    G4MaterialPropertiesTable* properties = material->GetMaterialPropertiesTable();
+    if (!properties || !properties->ConstPropertyExists("SCINTILLATIONYIELD")) return nullptr;
+
+    G4MaterialPropertyVector* component = properties->GetProperty("FASTCOMPONENT");
+    if (!component || component->GetVectorLength() < 2) return nullptr;
+
+    emission.fYield = properties->GetConstProperty("SCINTILLATIONYIELD");
+    if (properties->ConstPropertyExists("RESOLUTIONSCALE")) emission.fResolutionScale = properties->GetConstProperty("RESOLUTIONSCALE");
+    if (properties->ConstPropertyExists("FASTTIMECONSTANT")) emission.fDecayTime = properties->GetConstProperty("FASTTIMECONSTANT");
+
+    // Trapezoidal integral of the emission spectrum
+    std::size_t n = component->GetVectorLength();
+    emission.fEnergy.resize(n);
+    emission.fIntegral.resize(n);
+    emission.fEnergy[0] = component->Energy(0);
+    emission.fIntegral[0] = 0.;
+    for (std::size_t i = 1; i < n; i++) {
+        emission.fEnergy[i] = component->Energy(i);
+        emission.fIntegral[i] = emission.fIntegral[i-1]
+        + 0.5*((*component)[i] + (*component)[i-1])*(emission.fEnergy[i] - emission.fEnergy[i-1]);
+    }
+    if (emission.fIntegral.back() <= 0.) {
+        emission.fEnergy.clear();
+        emission.fIntegral.clear();
+        return nullptr;
+    }
+
+    return &emission;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ScintillationSampler::SampleNumberOfPhotons(const Emission& emission, G4double edep) const
+{
+    G4double meanNumber = emission.fYield*edep;
+    if (meanNumber > 10.) {
+        G4double sigma = emission.fResolutionScale*std::sqrt(meanNumber);
+        return std::max(G4int(G4RandGauss::shoot(meanNumber, sigma) + 0.5), 0);
+    }
+    return G4int(G4Poisson(meanNumber));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ScintillationSampler::SampleEnergy(const Emission& emission) const
+{
+    G4double integral = G4UniformRand()*emission.fIntegral.back();
+    std::size_t i = std::upper_bound(emission.fIntegral.begin(), emission.fIntegral.end(), integral)
+    - emission.fIntegral.begin();
+    if (i == 0) return emission.fEnergy.front();
+    if (i >= emission.fIntegral.size()) return emission.fEnergy.back();
+
+    G4double fraction = (integral - emission.fIntegral[i-1])/(emission.fIntegral[i] - emission.fIntegral[i-1]);
+    return emission.fEnergy[i-1] + fraction*(emission.fEnergy[i] - emission.fEnergy[i-1]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ScintillationSampler::SampleDelay(const Emission& emission) const
+{
+    if (emission.fDecayTime <= 0.) return 0.;
+    return -emission.fDecayTime*std::log(G4UniformRand());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScintillationSampler::SampleDirection(G4ThreeVector& direction, G4ThreeVector& polarization)
+{
+    G4double cost = 1. - 2.*G4UniformRand();
+    G4double sint = std::sqrt((1. - cost)*(1. + cost));
+    G4double phi = twopi*G4UniformRand();
+    direction.set(sint*std::cos(phi), sint*std::sin(phi), cost);
+
+    G4ThreeVector perpendicular = direction.orthogonal().unit();
+    G4double angle = twopi*G4UniformRand();
+    polarization = std::cos(angle)*perpendicular + std::sin(angle)*direction.cross(perpendicular);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScintillationSampler::SamplePhoton(const Emission& emission, const Genstep& genstep, Photon& photon) const
+{
+    G4double fraction = G4UniformRand();
+    photon.fPosition = genstep.fStart + fraction*(genstep.fEnd - genstep.fStart);
+    photon.fTime = genstep.fStartTime + fraction*(genstep.fEndTime - genstep.fStartTime) + SampleDelay(emission);
+    photon.fEnergy = SampleEnergy(emission);
+    SampleDirection(photon.fDirection, photon.fPolarization);
+}
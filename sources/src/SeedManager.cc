@@ -0,0 +1,66 @@
+#include "SeedManager.hh"
+#include "Logger.hh"
+
+#include "G4Event.hh"
+#include "G4RunManager.hh"
+#include "Randomize.hh"
+
+#include <cstdint>
+#include <ctime>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::atomic<G4long> SeedManager::fMasterSeed(0);
+std::atomic<G4int> SeedManager::fFirstEvent(0);
+
+namespace {
+    // One step of the SplitMix64 generator, used to mix the ids into the seed.
+    std::uint64_t SplitMix64(std::uint64_t& state)
+    {
+        std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int SeedManager::GetEventId(const G4Event* event)
+{
+    return event->GetEventID() + fFirstEvent.load(std::memory_order_relaxed);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SeedManager::BeginOfRun()
+{
+    if (fMasterSeed == 0) {
+        fMasterSeed = time(NULL) & 0x7fffffff;
+        D2TB_LOG(kInfo) << "*** No seed given, using the master seed " << fMasterSeed
+        << " (/d2tb/run/seed " << fMasterSeed << " to reproduce this run) ***";
+    }
+    else {
+        D2TB_LOG(kInfo) << "*** Master seed " << fMasterSeed << " ***";
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SeedManager::SeedEvent(const G4Event* event)
+{
+    G4int runId = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
+
+    std::uint64_t state = fMasterSeed.load(std::memory_order_relaxed);
+    SplitMix64(state);
+    state ^= static_cast<std::uint64_t>(static_cast<std::uint32_t>(runId)) << 32;
+    SplitMix64(state);
+    state ^= static_cast<std::uint32_t>(GetEventId(event));
+
+    // Two seeds in the ranges accepted by the Ranecu engine
+    long seeds[3];
+    seeds[0] = 1 + static_cast<long>(SplitMix64(state) % 2147483562ULL);
+    seeds[1] = 1 + static_cast<long>(SplitMix64(state) % 2147483398ULL);
+    seeds[2] = 0;
+    G4Random::setTheSeeds(seeds);
+}
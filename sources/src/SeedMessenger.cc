@@ -0,0 +1,59 @@
+#include "SeedMessenger.hh"
+#include "SeedManager.hh"
+
+#include <G4UIdirectory.hh>
+#include <G4UIcmdWithAnInteger.hh>
+
+SeedMessenger::SeedMessenger()
+{
+    fRunDIR = new G4UIdirectory("/d2tb/run/");
+    fRunDIR->SetGuidance("Run control commands.");
+
+    fSeedCMD = new G4UIcmdWithAnInteger("/d2tb/run/seed", this);
+    fSeedCMD->SetGuidance("Set the master seed. The seeds of each event are derived from it");
+    fSeedCMD->SetGuidance("and from the run and event ids, whatever the number of threads.");
+    fSeedCMD->SetGuidance("Zero chooses a seed from the time at the start of the next run.");
+    fSeedCMD->SetParameterName("seed", false);
+    fSeedCMD->SetRange("seed>=0");
+    fSeedCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fSeedCMD->SetToBeBroadcasted(false);
+
+    fFirstEventCMD = new G4UIcmdWithAnInteger("/d2tb/run/firstEvent", this);
+    fFirstEventCMD->SetGuidance("Set the id of the first event of the runs.");
+    fFirstEventCMD->SetGuidance("This is used to split a run in several processes.");
+    fFirstEventCMD->SetParameterName("id", false);
+    fFirstEventCMD->SetRange("id>=0");
+    fFirstEventCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fFirstEventCMD->SetToBeBroadcasted(false);
+}
+
+SeedMessenger::~SeedMessenger()
+{
+    delete fSeedCMD;
+    delete fFirstEventCMD;
+    delete fRunDIR;
+}
+
+void SeedMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fSeedCMD) {
+        SeedManager::SetMasterSeed(fSeedCMD->GetNewIntValue(newValue));
+    }
+    else if (command == fFirstEventCMD) {
+        SeedManager::SetFirstEvent(fFirstEventCMD->GetNewIntValue(newValue));
+    }
+}
+
+G4String SeedMessenger::GetCurrentValue(G4UIcommand * command)
+{
+    G4String currentValue;
+
+    if (command == fSeedCMD) {
+        currentValue = fSeedCMD->ConvertToString(G4int(SeedManager::GetMasterSeed()));
+    }
+    else if (command == fFirstEventCMD) {
+        currentValue = fFirstEventCMD->ConvertToString(SeedManager::GetFirstEvent());
+    }
+
+    return currentValue;
+}
@@ -7,19 +7,38 @@
 
 #include "StackingAction.hh"
 #include "EventAction.hh"
+#include "Logger.hh"
+#include "GenstepManager.hh"
+
+#include "Genstep.hh"
 
 #include "G4VProcess.hh"
+#include "G4ProcessTable.hh"
+#include "G4EventManager.hh"
+#include "G4StackManager.hh"
+#include "G4DynamicParticle.hh"
 #include "G4ParticleDefinition.hh"
 #include "G4ParticleTypes.hh"
 #include "G4Track.hh"
 #include "G4ios.hh"
+#include "G4Version.hh"
+
+#include <algorithm>
+#include <limits>
+
 
+G4int StackingAction::fSubEventSize = 0;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 StackingAction::StackingAction(EventAction* ea)
 : fEventAction(ea),
-fScintillationCounter(0)
+fScintillationCounter(0),
+fGenerating(false),
+fNewStage(false),
+fDeferred(nullptr),
+fLocal(nullptr),
+fScintillation(nullptr)
 {
 
 }
@@ -35,6 +54,13 @@ StackingAction::~StackingAction()
 
 G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack(const G4Track* aTrack)
 {
+    // At the start of a stage, the marker is dropped and the last photon of
+    // the previous batch is tracked
+    if (fNewStage) return GenstepManager::IsMarker(aTrack) ? fKill : fUrgent;
+
+    // The marker waits for the end of the shower to start the generation
+    if (GenstepManager::IsMarker(aTrack)) return fWaiting;
+
     if (aTrack->GetParentID() == 0) return fUrgent;
 
     // particle is optical photon
@@ -43,8 +69,22 @@ G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack(const G4Track* aTrac
         if(aTrack->GetParentID() > 0)     // particle is secondary
         {
             if(aTrack->GetCreatorProcess()->GetProcessName() == "Scintillation"){
+                // Only their step is kept, as a genstep, to be recorded or
+                // to generate them later
+                if (GenstepManager::IsRecording() && !fGenerating) return fKill;
+
                 fScintillationCounter++;
                 fEventAction->IncPhotonCount_Scint();
+
+                // The next batch is generated when this photon is tracked
+                if (aTrack == fDeferred) return fWaiting;
+                if (aTrack == fLocal) return fUrgent;
+
+                #if G4VERSION_NUMBER >= 1120
+                // The photons are bunched and tracked by the other threads,
+                // their hits are merged back in EventAction::MergeSubEvent
+                if (fSubEventSize > 0) return fSubEvent_0;
+                #endif
             }
         }
     }
@@ -56,7 +96,71 @@ G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack(const G4Track* aTrac
 
 void StackingAction::NewStage()
 {
-    G4cout << "StackingAction::NewStage() : Number of Scintillation photons produced in this event : " << fScintillationCounter << G4endl;
+    if (GenstepManager::IsLazy()) {
+        fNewStage = true;
+        stackManager->ReClassify();
+        fNewStage = false;
+
+        GeneratePhotons();
+    }
+
+    D2TB_LOG(kDebug) << "StackingAction::NewStage() : Number of Scintillation photons produced in this event : " << fScintillationCounter;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::GeneratePhotons()
+{
+    // Looked up once the processes are built
+    if (!fScintillation) {
+        fScintillation = G4ProcessTable::GetProcessTable()->FindProcess("Scintillation", G4Electron::Electron());
+    }
+
+    // One batch per stage: when photons are left, the last one of the batch
+    // waits until the others are tracked, and starts the next stage.
+    // Without batch size (replay), all the photons are one batch.
+    G4int batchSize = GenstepManager::GetBatchSize();
+    if (batchSize <= 0) batchSize = std::numeric_limits<G4int>::max();
+    if (fSubEventSize > 0) batchSize = std::max(batchSize, 2);
+    ScintillationSampler::Photon photon;
+    G4int nPhotons = 0;
+    while (G4int(fBatch.size()) < batchSize) {
+        const Genstep* genstep = GenstepManager::TakePhotons(batchSize - fBatch.size(), nPhotons);
+        if (!genstep) break;
+
+        const ScintillationSampler::Emission* emission = fSampler.GetEmission(genstep->fMaterial);
+        if (!emission) continue;
+
+        for (G4int i = 0; i < nPhotons; i++) {
+            fSampler.SamplePhoton(*emission, *genstep, photon);
+
+            G4DynamicParticle* particle = new G4DynamicParticle(G4OpticalPhoton::OpticalPhoton(), photon.fDirection, photon.fEnergy);
+            particle->SetPolarization(photon.fPolarization.x(), photon.fPolarization.y(), photon.fPolarization.z());
+
+            G4Track* track = new G4Track(particle, photon.fTime, photon.fPosition);
+            track->SetParentID(genstep->fTrackId);
+            track->SetCreatorProcess(fScintillation);
+            fBatch.push_back(track);
+        }
+    }
+    if (fBatch.empty()) return;
+
+    D2TB_LOG(kDebug) << "StackingAction::GeneratePhotons() : Batch of " << fBatch.size() << " photons";
+
+    // The event manager numbers the tracks and classifies them
+    // With sub-events, one more photon stays in this event so that the stage
+    // does not end with only the waiting one.
+    fDeferred = nullptr;
+    fLocal = nullptr;
+    if (GenstepManager::HasPendingPhotons()) {
+        fDeferred = fBatch.back();
+        if (fSubEventSize > 0 && fBatch.size() > 1) fLocal = fBatch[fBatch.size()-2];
+    }
+    fGenerating = true;
+    G4EventManager::GetEventManager()->StackTracks(&fBatch);
+    fGenerating = false;
+    fDeferred = nullptr;
+    fLocal = nullptr;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
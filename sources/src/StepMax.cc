@@ -1,13 +1,25 @@
 #include "G4Track.hh"
 #include "G4VParticleChange.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Region.hh"
+#include "G4LossTableManager.hh"
 
 #include "StepMax.hh"
 
+#include <algorithm>
+
+G4ThreadLocal const StepMax* StepMax::fCachedProcess = nullptr;
+G4ThreadLocal const G4Region* StepMax::fCachedRegion = nullptr;
+G4ThreadLocal G4int StepMax::fCachedVersion = 0;
+G4ThreadLocal G4double StepMax::fCachedStepMax = 0.;
+G4ThreadLocal G4double StepMax::fCachedRangeFraction = 0.;
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 StepMax::StepMax(const G4String& aName)
 : G4VDiscreteProcess(aName),
-fMaxChargedStep(DBL_MAX)
+fMaxChargedStep(DBL_MAX),
+fVersion(0)
 {
     if (verboseLevel>0) {
         G4cout << GetProcessName() << " is created " << G4endl;
@@ -20,7 +32,7 @@ StepMax::~StepMax() { }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-StepMax::StepMax(StepMax& right) : G4VDiscreteProcess(right) { }
+StepMax::StepMax(StepMax& right) : G4VDiscreteProcess(right), fVersion(0) { }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -31,18 +43,66 @@ G4bool StepMax::IsApplicable(const G4ParticleDefinition& particle)
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void StepMax::SetStepMax(G4double step) { fMaxChargedStep = step ; }
+void StepMax::SetStepMax(G4double step) { fMaxChargedStep = step ; ++fVersion; }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepMax::SetStepMax(const G4String& region, G4double step)
+{
+    fRegionStepMax[region] = step;
+    ++fVersion;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepMax::SetRangeFraction(const G4String& region, G4double fraction)
+{
+    fRangeFraction[region] = fraction;
+    ++fVersion;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepMax::UpdateCache(const G4Region* region)
+{
+    fCachedProcess = this;
+    fCachedRegion = region;
+    fCachedVersion = fVersion.load();
+
+    fCachedStepMax = fMaxChargedStep;
+    fCachedRangeFraction = 0.;
+    if (!region) return;
+
+    auto step = fRegionStepMax.find(region->GetName());
+    if (step != fRegionStepMax.end()) fCachedStepMax = step->second;
+
+    auto fraction = fRangeFraction.find(region->GetName());
+    if (fraction != fRangeFraction.end()) fCachedRangeFraction = fraction->second;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-G4double StepMax::PostStepGetPhysicalInteractionLength(const G4Track&, G4double, G4ForceCondition* condition)
+G4double StepMax::PostStepGetPhysicalInteractionLength(const G4Track& track, G4double, G4ForceCondition* condition)
 {
     // condition is set to "Not Forced"
     *condition = NotForced;
 
+    const G4Region* region = track.GetVolume()->GetLogicalVolume()->GetRegion();
+    if (fCachedProcess != this || fCachedRegion != region || fCachedVersion != fVersion.load(std::memory_order_relaxed)) {
+        UpdateCache(region);
+    }
+
     G4double ProposedStep = DBL_MAX;
 
-    if ( fMaxChargedStep > 0.) ProposedStep = fMaxChargedStep;
+    if ( fCachedStepMax > 0.) ProposedStep = fCachedStepMax;
+
+    // Long steps at high energy, down to the fixed limit at the end of the
+    // track where the position of the deposits matters
+    if ( fCachedRangeFraction > 0.) {
+        G4double range = G4LossTableManager::Instance()->GetRange(track.GetDefinition(),
+        track.GetKineticEnergy(), track.GetMaterialCutsCouple());
+        ProposedStep = std::max(fCachedRangeFraction*range, fCachedStepMax > 0. ? fCachedStepMax : 0.);
+    }
 
     return ProposedStep;
 }
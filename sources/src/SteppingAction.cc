@@ -5,6 +5,7 @@
 #include "DetectorConstruction.hh"
 #include "EventAction.hh"
 #include "SteppingActionMessenger.hh"
+#include "Logger.hh"
 
 #include "G4Step.hh"
 #include "G4Track.hh"
@@ -18,6 +19,8 @@
 #include "PhotonDetSD.hh"
 
 #include "UserTrackInformation.hh"
+#include "TrajectoryPolicy.hh"
+#include "GenstepManager.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -42,7 +45,37 @@ SteppingAction::~SteppingAction() {
 void SteppingAction::SetBounceLimit(G4int i)
 {
     fBounceLimit = i;
-    G4cout << "SteppingAction::SetBounceLimit() : Set reflection limit to " << fBounceLimit << G4endl;
+    D2TB_LOG(kInfo) << "SteppingAction::SetBounceLimit() : Set reflection limit to " << fBounceLimit;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SteppingAction::RecordGenstep(const G4Step* theStep)
+{
+    // The photons of the step are killed by the stacking action, only their
+    // number is kept
+    const std::vector<const G4Track*>* secondaries = theStep->GetSecondaryInCurrentStep();
+    G4int nPhotons = 0;
+    for (const G4Track* secondary : *secondaries) {
+        if (secondary->GetDefinition() == G4OpticalPhoton::OpticalPhotonDefinition()) nPhotons++;
+    }
+    if (nPhotons == 0) return;
+
+    G4StepPoint* thePrePoint  = theStep->GetPreStepPoint();
+    G4StepPoint* thePostPoint = theStep->GetPostStepPoint();
+    const G4Track* theTrack = theStep->GetTrack();
+
+    Genstep genstep;
+    genstep.fStart = thePrePoint->GetPosition();
+    genstep.fEnd = thePostPoint->GetPosition();
+    genstep.fStartTime = thePrePoint->GetGlobalTime();
+    genstep.fEndTime = thePostPoint->GetGlobalTime();
+    genstep.fEnergyDeposit = theStep->GetTotalEnergyDeposit();
+    genstep.fNumPhotons = nPhotons;
+    genstep.fTrackId = theTrack->GetTrackID();
+    genstep.fPDGCode = theTrack->GetDefinition()->GetPDGEncoding();
+    genstep.fMaterial = thePrePoint->GetMaterial();
+    GenstepManager::Record(genstep);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -55,6 +88,13 @@ void SteppingAction::UserSteppingAction(const G4Step *theStep) {
     G4StepPoint* thePrePoint  = theStep->GetPreStepPoint();
     G4StepPoint* thePostPoint = theStep->GetPostStepPoint();
 
+    //Path of a photon which only gets a trajectory if it is detected
+    if (TrajectoryPolicy::IsRecordingPath()) TrajectoryPolicy::RecordPoint(thePostPoint->GetPosition());
+
+    //Scintillating step whose photons are not tracked, or generated later
+    if (GenstepManager::IsRecording()
+        && theTrack->GetDefinition() != G4OpticalPhoton::OpticalPhotonDefinition()) RecordGenstep(theStep);
+
     G4VPhysicalVolume* thePrePV  = thePrePoint->GetPhysicalVolume();
     G4VPhysicalVolume* thePostPV = thePostPoint->GetPhysicalVolume();
 
@@ -140,13 +180,29 @@ void SteppingAction::UserSteppingAction(const G4Step *theStep) {
         default: break;
         }
 
+        //Kill the photons leaving the crystals or the SiPMs for the world.
+        //The post-step point is already in the world for the photons the
+        //boundary reflects, only the transmitted ones leave.
+        G4bool transmitted = (theStatus == FresnelRefraction || theStatus == Transmission
+            || theStatus == SameMaterial);
+        if (fDetector->GetKillPhotonsInWorld() && thePostPoint->GetStepStatus() == fGeomBoundary
+            && transmitted && theTrack->GetTrackStatus() != fStopAndKill
+            && thePostPV->GetLogicalVolume()->GetRegion() == fDetector->GetWorldRegion()
+            && thePrePV->GetLogicalVolume()->GetRegion() != fDetector->GetWorldRegion()) {
+            theTrack->SetTrackStatus(fStopAndKill);
+            trackInformation->AddTrackStatusFlag(murderee);
+            trackInformation->SetExitPosition( thePostPoint->GetPosition() );
+            ResetCounters();
+            return;
+        }
+
         //Check for bounce limit
         if (fBounceLimit > 0 && fCounterBounce >= fBounceLimit)
         {
             theTrack->SetTrackStatus(fStopAndKill);
             trackInformation->AddTrackStatusFlag(murderee);
             ResetCounters();
-            G4cout << "SteppingAction::UserSteppingAction() : Bounce Limit Exceeded" << G4endl;
+            D2TB_LOG_LIMITED(kInfo, "SteppingAction::BounceLimit") << "SteppingAction::UserSteppingAction() : Bounce Limit Exceeded";
             return;
         }
     }
@@ -12,19 +12,33 @@
 #include "G4ParticleTypes.hh"
 
 #include "Trajectory.hh"
+#include "TrajectoryPolicy.hh"
 #include "UserTrackInformation.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 TrackingAction::TrackingAction()
+: fStoreTrajectory(0)
 { }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void TrackingAction::PreUserTrackingAction(const G4Track* aTrack)
 {
-    //Use custom trajectory class
-    fpTrackingManager->SetTrajectory(new Trajectory(aTrack));
+    //Use custom trajectory class, only when the trajectories are stored
+    //(vis or /tracking/storeTrajectory) and for the tracks selected by the
+    //policy.  The others get no trajectory at all (the tracking manager
+    //would create its own if the flag was left on).
+    fStoreTrajectory = fpTrackingManager->GetStoreTrajectory();
+    if (fStoreTrajectory) {
+        if (TrajectoryPolicy::IsSelected(aTrack)) {
+            fpTrackingManager->SetTrajectory(new Trajectory(aTrack));
+        }
+        else {
+            fpTrackingManager->SetStoreTrajectory(0);
+            if (TrajectoryPolicy::IsDeferred(aTrack)) TrajectoryPolicy::StartPath();
+        }
+    }
     UserTrackInformation* trackInformation = new UserTrackInformation();
 
     G4String PVName = aTrack->GetVolume()->GetName();
@@ -39,17 +53,23 @@ void TrackingAction::PreUserTrackingAction(const G4Track* aTrack)
 
 void TrackingAction::PostUserTrackingAction(const G4Track* aTrack)
 {
+    if (!fStoreTrajectory) return;
+
     Trajectory* trajectory = (Trajectory*)fpTrackingManager->GimmeTrajectory();
-    UserTrackInformation* trackInformation = (UserTrackInformation*)aTrack->GetUserInformation();
 
-    //Lets choose to draw only the photons that hit the sipm
-    if(aTrack->GetDefinition() == G4OpticalPhoton::OpticalPhotonDefinition()) {
-        if(trackInformation->GetTrackStatus()&hitSiPM) {
-            trajectory->SetDrawTrajectory(true);
+    //The photons only get their trajectory once they hit the sipm
+    if (TrajectoryPolicy::IsRecordingPath()) {
+        TrajectoryPolicy::StopPath();
+        UserTrackInformation* trackInformation = (UserTrackInformation*)aTrack->GetUserInformation();
+        if (trackInformation->GetTrackStatus()&hitSiPM) {
+            trajectory = Trajectory::FromPath(aTrack, TrajectoryPolicy::GetPath());
+            fpTrackingManager->SetTrajectory(trajectory);
         }
     }
-    else //draw all other trajectories
-    trajectory->SetDrawTrajectory(true);
+    fpTrackingManager->SetStoreTrajectory(fStoreTrajectory);
+
+    //Only a sample of the trajectories kept is drawn
+    if (trajectory) trajectory->SetDrawTrajectory(TrajectoryPolicy::IsDrawn(aTrack));
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
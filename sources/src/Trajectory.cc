@@ -1,15 +1,16 @@
 #include "Trajectory.hh"
+#include "TrajectoryPolicy.hh"
 
 #include "G4Trajectory.hh"
 #include "G4ParticleTable.hh"
 #include "G4ParticleTypes.hh"
 #include "G4ThreeVector.hh"
 #include "G4Polyline.hh"
-#include "G4Circle.hh"
 #include "G4Colour.hh"
 #include "G4VisAttributes.hh"
 #include "G4VVisManager.hh"
-#include "G4Polymarker.hh"
+
+#include <algorithm>
 
 G4ThreadLocal G4Allocator<Trajectory>* TrajectoryAllocator = nullptr;
 
@@ -17,7 +18,8 @@ G4ThreadLocal G4Allocator<Trajectory>* TrajectoryAllocator = nullptr;
 
 Trajectory::Trajectory()
 : G4Trajectory(),
-fDrawit(false)
+fDrawit(false),
+fPolyline(nullptr)
 {
     fParticleDefinition = nullptr;
 }
@@ -26,7 +28,8 @@ fDrawit(false)
 
 Trajectory::Trajectory(const G4Track* aTrack)
 : G4Trajectory(aTrack),
-fDrawit(false)
+fDrawit(false),
+fPolyline(nullptr)
 {
     fParticleDefinition = aTrack->GetDefinition();
 }
@@ -35,7 +38,8 @@ fDrawit(false)
 
 Trajectory::Trajectory(Trajectory & right)
 : G4Trajectory(right),
-fDrawit(right.fDrawit)
+fDrawit(right.fDrawit),
+fPolyline(nullptr)
 {
     fParticleDefinition=right.fParticleDefinition;
 }
@@ -44,57 +48,108 @@ fDrawit(right.fDrawit)
 
 Trajectory::~Trajectory()
 {
+    delete fPolyline;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void Trajectory::DrawTrajectory() const
+Trajectory* Trajectory::FromPath(const G4Track* aTrack, const std::vector<G4ThreeVector>& path)
+{
+    // The trajectory starts where the track was at its vertex
+    G4Track start(*aTrack);
+    start.SetPosition(aTrack->GetVertexPosition());
+    start.SetMomentumDirection(aTrack->GetVertexMomentumDirection());
+    start.SetKineticEnergy(aTrack->GetVertexKineticEnergy());
+
+    Trajectory* trajectory = new Trajectory(&start);
+
+    // The points are appended as the tracking manager does after each step
+    G4Step step;
+    for (const auto& position : path) {
+        step.GetPostStepPoint()->SetPosition(position);
+        trajectory->AppendStep(&step);
+    }
+
+    return trajectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Trajectory::DouglasPeucker(const std::vector<G4ThreeVector>& points,
+                                G4double tolerance, std::vector<char>& keep)
 {
-    const G4int i_mode = 50;
+    // Keep the farthest point from the chord of each section while it is out
+    // of the tolerance, then split the section there.
+    std::vector<std::pair<std::size_t, std::size_t> > sections;
+    if (points.size() > 2) sections.push_back(std::make_pair(std::size_t(0), points.size()-1));
+    while (!sections.empty()) {
+        std::size_t first = sections.back().first;
+        std::size_t last = sections.back().second;
+        sections.pop_back();
+        if (last <= first + 1) continue;
+
+        G4ThreeVector chord = points[last] - points[first];
+        G4double length2 = chord.mag2();
+        G4double maxDistance = -1;
+        std::size_t farthest = first;
+        for (std::size_t p = first + 1; p < last; ++p) {
+            G4ThreeVector offset = points[p] - points[first];
+            if (length2 > 0) {
+                G4double t = std::min(std::max(offset.dot(chord)/length2, 0.), 1.);
+                offset -= t*chord;
+            }
+            G4double distance = offset.mag();
+            if (distance > maxDistance) {
+                maxDistance = distance;
+                farthest = p;
+            }
+        }
+
+        if (maxDistance > tolerance) {
+            keep[farthest] = 1;
+            sections.push_back(std::make_pair(first, farthest));
+            sections.push_back(std::make_pair(farthest, last));
+        }
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void Trajectory::DrawTrajectory() const
+{
     if(!fDrawit) return;
 
     G4VVisManager* pVVisManager = G4VVisManager::GetConcreteInstance();
     if (!pVVisManager) return;
 
-    const G4double markerSize = std::abs(i_mode)/1000;
-    G4bool lineRequired (i_mode >= 0);
-    G4bool markersRequired (markerSize > 0.);
-
-    G4Polyline trajectoryLine;
-    G4Polymarker stepPoints;
-    G4Polymarker auxiliaryPoints;
-
-    for (G4int i = 0; i < GetPointEntries() ; i++)
-    {
-        G4VTrajectoryPoint* aTrajectoryPoint = GetPoint(i);
-        const std::vector<G4ThreeVector>* auxiliaries
-        = aTrajectoryPoint->GetAuxiliaryPoints();
-        if (auxiliaries)
+    // The viewer redraws the kept events on every refresh, the polyline is
+    // only built the first time.
+    if (!fPolyline) {
+        std::vector<G4ThreeVector> points;
+        points.reserve(GetPointEntries());
+        for (G4int i = 0; i < GetPointEntries() ; i++)
         {
-            for (size_t iAux = 0; iAux < auxiliaries->size(); ++iAux)
-            {
-                const G4ThreeVector pos((*auxiliaries)[iAux]);
-                if (lineRequired) {
-                    trajectoryLine.push_back(pos);
-                }
-                if (markersRequired) {
-                    auxiliaryPoints.push_back(pos);
-                }
-            }
+            G4VTrajectoryPoint* aTrajectoryPoint = GetPoint(i);
+            const std::vector<G4ThreeVector>* auxiliaries
+            = aTrajectoryPoint->GetAuxiliaryPoints();
+            if (auxiliaries) points.insert(points.end(), auxiliaries->begin(), auxiliaries->end());
+            points.push_back(aTrajectoryPoint->GetPosition());
         }
 
-        const G4ThreeVector pos(aTrajectoryPoint->GetPosition());
-        if (lineRequired) {
-            trajectoryLine.push_back(pos);
+        std::vector<char> keep(points.size(), 1);
+        G4double tolerance = TrajectoryPolicy::GetDrawTolerance();
+        if (points.size() > 2 && tolerance > 0) {
+            std::fill(keep.begin(), keep.end(), 0);
+            keep.front() = keep.back() = 1;
+            DouglasPeucker(points, tolerance, keep);
         }
-        if (markersRequired) {
-            stepPoints.push_back(pos);
+
+        fPolyline = new G4Polyline();
+        fPolyline->reserve(std::count(keep.begin(), keep.end(), 1));
+        for (std::size_t p = 0; p < points.size(); ++p) {
+            if (keep[p]) fPolyline->push_back(points[p]);
         }
-    }
 
-    if (lineRequired)
-    {
         G4Colour colour;
         if(fParticleDefinition==G4OpticalPhoton::OpticalPhotonDefinition()) {
             //Scintillation and Cerenkov photons are green
@@ -104,27 +159,10 @@ void Trajectory::DrawTrajectory() const
             //All other particles are blue
             colour = G4Colour(0.,0.,1.);
         }
-
-        G4VisAttributes trajectoryLineAttribs(colour);
-        trajectoryLine.SetVisAttributes(&trajectoryLineAttribs);
-        pVVisManager->Draw(trajectoryLine);
-    }
-    if (markersRequired)
-    {
-        auxiliaryPoints.SetMarkerType(G4Polymarker::squares);
-        auxiliaryPoints.SetScreenSize(markerSize);
-        auxiliaryPoints.SetFillStyle(G4VMarker::filled);
-        G4VisAttributes auxiliaryPointsAttribs(G4Colour(0.,1.,1.));  // Magenta
-        auxiliaryPoints.SetVisAttributes(&auxiliaryPointsAttribs);
-        pVVisManager->Draw(auxiliaryPoints);
-
-        stepPoints.SetMarkerType(G4Polymarker::circles);
-        stepPoints.SetScreenSize(markerSize);
-        stepPoints.SetFillStyle(G4VMarker::filled);
-        G4VisAttributes stepPointsAttribs(G4Colour(1.,1.,0.));  // Yellow
-        stepPoints.SetVisAttributes(&stepPointsAttribs);
-        pVVisManager->Draw(stepPoints);
+        fPolyline->SetVisAttributes(G4VisAttributes(colour));
     }
+
+    pVVisManager->Draw(*fPolyline);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
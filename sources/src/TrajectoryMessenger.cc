@@ -0,0 +1,95 @@
+#include "TrajectoryMessenger.hh"
+#include "TrajectoryPolicy.hh"
+
+#include <G4UIdirectory.hh>
+#include <G4UIcmdWithAString.hh>
+#include <G4UIcmdWithAnInteger.hh>
+#include <G4UIcmdWithADoubleAndUnit.hh>
+
+TrajectoryMessenger::TrajectoryMessenger()
+{
+    fTrajectoryDIR = new G4UIdirectory("/d2tb/trajectory/");
+    fTrajectoryDIR->SetGuidance("Trajectories of the tracks.");
+
+    fStoreCMD = new G4UIcmdWithAString("/d2tb/trajectory/store", this);
+    fStoreCMD->SetGuidance("Select the tracks which get a trajectory when the trajectories are stored");
+    fStoreCMD->SetGuidance("(/tracking/storeTrajectory or /vis/scene/add/trajectories).");
+    fStoreCMD->SetGuidance("  none            : no trajectory");
+    fStoreCMD->SetGuidance("  charged         : the charged particles");
+    fStoreCMD->SetGuidance("  detectedPhotons : all but the optical photons, and the detected ones (default)");
+    fStoreCMD->SetGuidance("  all             : every track");
+    fStoreCMD->SetParameterName("policy", false);
+    fStoreCMD->SetCandidates("none charged detectedPhotons all");
+    fStoreCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fStoreCMD->SetToBeBroadcasted(false);
+
+    fDrawPhotonsCMD = new G4UIcmdWithAnInteger("/d2tb/trajectory/drawPhotons", this);
+    fDrawPhotonsCMD->SetGuidance("Draw one in n of the optical photons which have a trajectory (default 1).");
+    fDrawPhotonsCMD->SetParameterName("n", false);
+    fDrawPhotonsCMD->SetRange("n>=1");
+    fDrawPhotonsCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fDrawPhotonsCMD->SetToBeBroadcasted(false);
+
+    fMaxDrawnCMD = new G4UIcmdWithAnInteger("/d2tb/trajectory/maxDrawn", this);
+    fMaxDrawnCMD->SetGuidance("Maximum number of trajectories drawn per event (default 5000).");
+    fMaxDrawnCMD->SetGuidance("0 draws all of them.");
+    fMaxDrawnCMD->SetParameterName("max", false);
+    fMaxDrawnCMD->SetRange("max>=0");
+    fMaxDrawnCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fMaxDrawnCMD->SetToBeBroadcasted(false);
+
+    fDrawToleranceCMD = new G4UIcmdWithADoubleAndUnit("/d2tb/trajectory/drawTolerance", this);
+    fDrawToleranceCMD->SetGuidance("Tolerance of the decimation of the points of the trajectories drawn (default 0.1 mm).");
+    fDrawToleranceCMD->SetGuidance("0 draws every point.");
+    fDrawToleranceCMD->SetParameterName("tolerance", false);
+    fDrawToleranceCMD->SetRange("tolerance>=0");
+    fDrawToleranceCMD->SetUnitCategory("Length");
+    fDrawToleranceCMD->SetDefaultUnit("mm");
+    fDrawToleranceCMD->AvailableForStates(G4State_PreInit, G4State_Idle);
+    fDrawToleranceCMD->SetToBeBroadcasted(false);
+}
+
+TrajectoryMessenger::~TrajectoryMessenger()
+{
+    delete fStoreCMD;
+    delete fDrawPhotonsCMD;
+    delete fMaxDrawnCMD;
+    delete fDrawToleranceCMD;
+    delete fTrajectoryDIR;
+}
+
+void TrajectoryMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fStoreCMD) {
+        TrajectoryPolicy::SetMode(TrajectoryPolicy::GetModeFromName(newValue));
+    }
+    else if (command == fDrawPhotonsCMD) {
+        TrajectoryPolicy::SetPhotonDrawStride(fDrawPhotonsCMD->GetNewIntValue(newValue));
+    }
+    else if (command == fMaxDrawnCMD) {
+        TrajectoryPolicy::SetMaxDrawn(fMaxDrawnCMD->GetNewIntValue(newValue));
+    }
+    else if (command == fDrawToleranceCMD) {
+        TrajectoryPolicy::SetDrawTolerance(fDrawToleranceCMD->GetNewDoubleValue(newValue));
+    }
+}
+
+G4String TrajectoryMessenger::GetCurrentValue(G4UIcommand * command)
+{
+    G4String currentValue;
+
+    if (command == fStoreCMD) {
+        currentValue = TrajectoryPolicy::GetModeName(TrajectoryPolicy::GetMode());
+    }
+    else if (command == fDrawPhotonsCMD) {
+        currentValue = fDrawPhotonsCMD->ConvertToString(TrajectoryPolicy::GetPhotonDrawStride());
+    }
+    else if (command == fMaxDrawnCMD) {
+        currentValue = fMaxDrawnCMD->ConvertToString(TrajectoryPolicy::GetMaxDrawn());
+    }
+    else if (command == fDrawToleranceCMD) {
+        currentValue = fDrawToleranceCMD->ConvertToString(TrajectoryPolicy::GetDrawTolerance(), "mm");
+    }
+
+    return currentValue;
+}
@@ -0,0 +1,97 @@
+#include "TrajectoryPolicy.hh"
+
+#include "G4Track.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::atomic<G4int> TrajectoryPolicy::fMode(TrajectoryPolicy::kDetectedPhotons);
+std::atomic<G4int> TrajectoryPolicy::fPhotonDrawStride(1);
+std::atomic<G4int> TrajectoryPolicy::fMaxDrawn(5000);
+std::atomic<G4double> TrajectoryPolicy::fDrawTolerance(0.1*mm);
+
+G4ThreadLocal G4int TrajectoryPolicy::fPhotonsKept = 0;
+G4ThreadLocal G4int TrajectoryPolicy::fDrawn = 0;
+
+G4ThreadLocal G4bool TrajectoryPolicy::fRecording = false;
+G4ThreadLocal std::vector<G4ThreeVector>* TrajectoryPolicy::fPath = nullptr;
+
+namespace {
+    const char* kModeNames[] = { "none", "charged", "detectedPhotons", "all" };
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String TrajectoryPolicy::GetModeName(G4int mode)
+{
+    if (mode < kNone || mode > kAll) return "";
+    return kModeNames[mode];
+}
+
+G4int TrajectoryPolicy::GetModeFromName(const G4String& name)
+{
+    for (G4int mode = kNone; mode <= kAll; mode++) {
+        if (name == kModeNames[mode]) return mode;
+    }
+    return kDetectedPhotons;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool TrajectoryPolicy::IsSelected(const G4Track* aTrack)
+{
+    switch (fMode.load(std::memory_order_relaxed)) {
+        case kAll:
+            return true;
+        case kCharged:
+            return aTrack->GetDefinition()->GetPDGCharge() != 0.;
+        case kDetectedPhotons:
+            return aTrack->GetDefinition() != G4OpticalPhoton::OpticalPhotonDefinition();
+    }
+    return false;
+}
+
+G4bool TrajectoryPolicy::IsDeferred(const G4Track* aTrack)
+{
+    return fMode.load(std::memory_order_relaxed) == kDetectedPhotons
+    && aTrack->GetDefinition() == G4OpticalPhoton::OpticalPhotonDefinition();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrajectoryPolicy::StartEvent()
+{
+    fPhotonsKept = 0;
+    fDrawn = 0;
+}
+
+G4bool TrajectoryPolicy::IsDrawn(const G4Track* aTrack)
+{
+    G4int maxDrawn = fMaxDrawn.load(std::memory_order_relaxed);
+    if (maxDrawn > 0 && fDrawn >= maxDrawn) return false;
+
+    if (aTrack->GetDefinition() == G4OpticalPhoton::OpticalPhotonDefinition()) {
+        G4int stride = std::max(fPhotonDrawStride.load(std::memory_order_relaxed), 1);
+        if (fPhotonsKept++ % stride != 0) return false;
+    }
+
+    fDrawn++;
+    return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrajectoryPolicy::StartPath()
+{
+    if (!fPath) fPath = new std::vector<G4ThreeVector>;
+    fPath->clear();
+    fRecording = true;
+}
+
+void TrajectoryPolicy::StopPath()
+{
+    fRecording = false;
+}
@@ -3,6 +3,8 @@
 
 #include "UserTrackInformation.hh"
 
+G4ThreadLocal G4Allocator<UserTrackInformation>* UserTrackInformationAllocator = 0;
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 UserTrackInformation::UserTrackInformation ()
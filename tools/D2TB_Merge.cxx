@@ -0,0 +1,48 @@
+#include "TG4OutputMerger.hh"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+void PrintUsage() {
+    std::cout << "Usage: d2tb_merge -o merged.root shard.root [shard.root ...]" << std::endl;
+    std::cout << "    -o <file>  -- The merged output file" << std::endl;
+    std::cout << "    -h         -- This help message." << std::endl;
+
+    exit(1);
+}
+
+int main(int argc, char** argv)
+{
+    std::string outputFilename;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg(argv[i]);
+        if      (arg == "-o" && i+1 < argc) { outputFilename = argv[i+1]; i++; }
+        else if (arg == "-h" || arg[0] == '-') PrintUsage();
+        else inputs.push_back(arg);
+    }
+
+    if (outputFilename.empty() || inputs.empty()) PrintUsage();
+
+    TG4OutputMerger merger;
+    for (const auto& input : inputs) merger.AddFile(input);
+
+    if (!merger.Merge(outputFilename)) {
+        std::cout << "d2tb_merge -- Cannot merge the files in " << outputFilename << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n ======================== Merge Summary ======================\n";
+    std::cout << inputs.size() << " files merged in " << outputFilename << std::endl;
+    for (const auto& run : merger.GetRunSummaries()) {
+        std::cout << "Run " << run.first << " : " << run.second.Events << " events, "
+        << "detected photons per event " << run.second.DetectedMean
+        << " +- " << run.second.GetDetectedSigma()
+        << ", resolution " << run.second.GetResolution() << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,55 @@
+#!/bin/sh
+# Check that two configurations of the same job agree, with a fixed seed:
+#
+#   batch : the photons generated by batches (/d2tb/genstep/batchSize) and
+#           stacked with their step (batchSize 0)
+#   subevt: the optical photons tracked in sub-events (-r subevt) and in
+#           their event (-r serial)
+#
+# The events are the same but the random numbers are not drawn in the same
+# order, the numbers of events must be equal and the detected photons per
+# event agree within 5 standard errors.
+#
+# Usage: d2tb_check.sh [check] [macro] [events] [seed]
+
+CHECK=${1:-batch}
+MACRO=${2:-electron.mac}
+EVENTS=${3:-20}
+SEED=${4:-1234}
+BINDIR=$(dirname "$0")
+
+EXE="$BINDIR/d2tb_calo_batch"
+[ -x "$EXE" ] || EXE="$BINDIR/d2tb_calo"
+
+# Run the macro followed by some commands, and print the number of events and
+# the mean and sigma of the detected photons per event
+run() {
+    printf '/control/execute %s\n%s\n' "$MACRO" "$2" > check.$$.mac
+    "$EXE" $1 -m check.$$.mac -s "$SEED" -e "$EVENTS" 2>&1 | awk '
+        /The run was/ { n = $4 }
+        /Detected photons per event \(mean, sigma\)/ { mean = $(NF-1); sigma = $NF }
+        END { print n, mean, sigma }'
+}
+
+case "$CHECK" in
+    batch)
+        A=$(run "" "/d2tb/genstep/batchSize 0")
+        B=$(run "" "/d2tb/genstep/batchSize 1000")
+        ;;
+    subevt)
+        A=$(run "-r serial" "")
+        B=$(run "-r subevt" "")
+        ;;
+    *)
+        echo "Unknown check: $CHECK"
+        exit 1
+        ;;
+esac
+rm -f check.$$.mac
+
+echo "$A $B" | awk -v check="$CHECK" '{
+    error = sqrt(($3*$3)/($1 > 0 ? $1 : 1) + ($6*$6)/($4 > 0 ? $4 : 1))
+    printf "%s: %d events, %g +- %g detected photons / %d events, %g +- %g\n", check, $1, $2, $3, $4, $5, $6
+    if ($1 == 0 || $1 != $4 || ($2-$5)*($2-$5) > 25*error*error) { print "FAILED"; exit 1 }
+    print "OK"
+}'
@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""Split a D2TB_Calo job in shards for a batch farm.
+
+Each shard runs a disjoint range of event ids with the same master seed.
+Since the events are seeded from the master seed and their ids, the shards
+never share random streams and their merged output (d2tb_merge) is the one
+of a single job of all the events.
+
+Example:
+
+    d2tb_shard.py electron.mac -e 100000 -n 50 -s 1234 -o output.root > jobs.txt
+    # submit each line of jobs.txt, then
+    d2tb_merge -o output.root output_s*.root
+"""
+
+import argparse
+import os
+import random
+import sys
+
+
+def shard_ranges(events, shards):
+    """Return the (first event, number of events) of each shard."""
+    ranges = []
+    for k in range(shards):
+        begin = events * k // shards
+        end = events * (k + 1) // shards
+        ranges.append((begin, end - begin))
+    return ranges
+
+
+def shard_filename(output, k, width):
+    """The output file of the k-th shard (name_s<k>.root)."""
+    base = output[:-5] if output.endswith(".root") else output
+    return "%s_s%0*d.root" % (base, width, k)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("macro", help="macro setting the geometry and the gun")
+    parser.add_argument("-e", "--events", type=int, required=True,
+                        help="total number of events")
+    parser.add_argument("-n", "--shards", type=int, required=True,
+                        help="number of shards")
+    parser.add_argument("-s", "--seed", type=int, default=0,
+                        help="master seed (chosen at random if not given)")
+    parser.add_argument("-f", "--first-event", type=int, default=0,
+                        help="id of the first event of the job")
+    parser.add_argument("-o", "--output", default="simulation-output.root",
+                        help="output file, the shards write name_s<k>.root")
+    parser.add_argument("-x", "--executable", default="bin/D2TB_Calo",
+                        help="the simulation executable")
+    parser.add_argument("-t", "--threads", type=int, default=None,
+                        help="number of threads of each shard")
+    parser.add_argument("-m", "--macros", metavar="DIR", default=None,
+                        help="write one macro per shard in DIR instead of "
+                        "passing everything on the command line")
+    args = parser.parse_args()
+
+    if args.events < 1 or args.shards < 1:
+        parser.error("the numbers of events and shards must be positive")
+
+    seed = args.seed
+    if seed == 0:
+        seed = random.randint(1, 2**31 - 1)
+        sys.stderr.write("d2tb_shard: master seed %d\n" % seed)
+
+    width = max(3, len(str(args.shards - 1)))
+    threads = [] if args.threads is None else ["-t", str(args.threads)]
+
+    if args.macros:
+        os.makedirs(args.macros, exist_ok=True)
+
+    for k, (begin, count) in enumerate(shard_ranges(args.events, args.shards)):
+        if count == 0:
+            continue
+        output = shard_filename(args.output, k, width)
+        first = args.first_event + begin
+
+        if args.macros:
+            macro = os.path.join(args.macros, "shard_%0*d.mac" % (width, k))
+            with open(macro, "w") as out:
+                out.write("# Shard %d of %d: events %d to %d\n"
+                          % (k, args.shards, first, first + count - 1))
+                out.write("/control/execute %s\n" % args.macro)
+                out.write("/d2tb/run/seed %d\n" % seed)
+                out.write("/d2tb/run/firstEvent %d\n" % first)
+                out.write("/d2tb/root/open %s\n" % output)
+            command = [args.executable, "-m", macro, "-e", str(count)] + threads
+        else:
+            command = [args.executable, "-m", args.macro, "-s", str(seed),
+                       "-f", str(first), "-e", str(count), "-o", output] + threads
+
+        print(" ".join(command))
+
+
+if __name__ == "__main__":
+    main()
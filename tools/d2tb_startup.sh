@@ -0,0 +1,24 @@
+#!/bin/sh
+# Compare the startup time (initialization and physics tables, no event) and
+# the peak resident memory of the interactive and batch executables.
+#
+# Usage: d2tb_startup.sh [macro] [repeat]
+
+MACRO=${1:-electron.mac}
+REPEAT=${2:-5}
+BINDIR=$(dirname "$0")
+
+for EXE in d2tb_calo d2tb_calo_batch; do
+    if [ ! -x "$BINDIR/$EXE" ]; then
+        echo "$EXE: not built"
+        continue
+    fi
+    i=0
+    while [ $i -lt "$REPEAT" ]; do
+        /usr/bin/time -f "%e %M" -o startup.$$ "$BINDIR/$EXE" -m "$MACRO" -e 0 > /dev/null 2>&1
+        cat startup.$$
+        i=$((i+1))
+    done | awk -v exe="$EXE" '{ t += $1; m += $2; n++ }
+        END { if (n) printf "%-16s %6.2f s  %8.1f MB  (mean of %d)\n", exe, t/n, m/n/1024, n }'
+done
+rm -f startup.$$